@@ -2,15 +2,37 @@
 #include <stdlib.h>  // ڶ̬ڴ䣨malloc, free, realloc
 #include <string.h>  // ַstrcpy, strcmp, strlenȣ
 #include <time.h>    // ʱɣtime
+#include <ctype.h>   // ַжϣisalnum, tolower
+#include <stdarg.h>  // ڿɱva_list, vsnprintf
+#include <math.h>    // ȻlogBM25ĵƵʣʱ -lm
 #define MAX_CONTENT_LEN 512      // 󳤶
 #define MAX_AUTHOR_LEN 64        // 󳤶
 #define MAX_DEPTH 3              // Ƕȣ3㣩
 #define INIT_CHILDREN_CAPACITY 4 // ʼӽڵ
+#define INIT_ID_INDEX_CAPACITY 64 // IDʼ
+#define MAX_TOKEN_LEN 16         // ʵֽβ'\0'
+#define MAX_TOKENS_PER_TEXT 1024 // һıг
+#define INIT_TERM_CAPACITY 1024  // ʱʼ2ݣ
+#define MAX_SEARCH_RESULTS 20    // ȫÿʾ
+#define MAX_QUERY_PHRASES 8      // һβѯ˫Ŷ
+#define PAGE_ITEM_LEN (MAX_CONTENT_LEN + MAX_AUTHOR_LEN + 128) // ҳһۣ۵ʾռõֽ
+#define DEFAULT_PAGE_SIZE 20     // ҳĬÿҳ
+#define MAX_PAGE_SIZE 1000       // ҳÿҳԼ0.7MB
+#define SYNTHETIC_NEW_THREAD_PERCENT 5 // ϳ¿۵ĸʣ%
+#define SYNTHETIC_AUTHORS 100000 // ϳݵ
+#ifndef ENABLE_METRICS
+#define ENABLE_METRICS 1         // ͳƿأʱ -DENABLE_METRICS=0 ȫȥͳƴ
+#endif
+#define LATENCY_BUCKETS 32       // ӳֱͼͰiͰͳ [2^i, 2^(i+1)) 
+#define LATENCY_SAMPLE_RATE 16   // ÿٴεüʱһΣ2ݣʱӱO(1)ұ
+#define INIT_AUTHOR_STAT_CAPACITY 256 // ͳƱʼ2ݣ
+#define TOP_AUTHOR_COUNT 10      // ͳʾд
+#define LIKE_BUFFER_CAPACITY 4096 // ޻Ĳλ2ݣͬﵽ3/4ʱϲд
 // ۽ڵṹ壨ڵ㣩
 typedef struct CommentNode {
     int id;                      // IDΨһʶ
-    char content[MAX_CONTENT_LEN]; // 
-    char author[MAX_AUTHOR_LEN];   // 
+    char* content;                 // ݣһڽڵ棬ͽڵһη䣩
+    char* author;                  // 
     time_t timestamp;              // ʱ
     int likeCount;                 // 
 
@@ -19,6 +41,10 @@ typedef struct CommentNode {
     struct CommentNode** children;   // ӽڵ飨̬䣩
     int childCount;                // ǰӽڵ
     int childCapacity;              // ӽڵ
+    int deletedChildCount;          // childrenɾµĿλĹ
+    int descendantCount;            // лظԼɾʱظά
+    int slotIndex;                  // ڸڵchildrenrootCommentsе±
+    struct FrozenThread* frozen;    // NULLʾ¥Ѷᣨֻãظڽ
     int depth;                     // Ƕȣ0ʾۣ
 } CommentNode;
 // вԽṹ
@@ -37,16 +63,818 @@ typedef struct CommentNode {
     free(comment);
     return 0;
 }*/
+// ۣǰУƫƴָ
+typedef struct {
+    int id;
+    int likeCount;
+    time_t timestamp;
+    int authorOffset;            // authorsıеƫƣͬһֻһݣ
+    int contentOffset;           // contentsıеƫ
+    int subtreeSize;             // ڵԼ[i, i+subtreeSize) 
+    int depth;                   // Ƕ
+} FrozenComment;
+
+// ¥аID
+typedef struct {
+    int id;
+    int offset;                  // nodesе±
+} FrozenIdEntry;
+
+// ¥ٱ仯¥۵ֻձʾ
+typedef struct FrozenThread {
+    FrozenComment* nodes;        // ǰ飬nodes[0]
+    int nodeCount;
+    FrozenIdEntry* idOrder;      // IDڶֲ
+    char* authors;               // ȥغı
+    int authorsSize;
+    char* contents;              // ı
+    int contentsSize;
+} FrozenThread;
+
+// ۵ֻͼڻ򶳽¥жԶȡⶳ
+typedef struct {
+    int id;
+    const char* author;
+    const char* content;
+    int likeCount;
+    int depth;
+    int replyCount;              // лظ
+} CommentView;
+
+// űID洢 (IDֵ, Ƶ)ñ䳤ֽڱѹ
+typedef struct {
+    char token[MAX_TOKEN_LEN];   // ʣմʾϣղۣ
+    unsigned char* data;         // ѹĵ
+    int size;                    // ֽ
+    int capacity;                // 
+    int docFreq;                 // ¼ܺɾδۣ
+    int lastDocId;               // һ¼IDڲֵ룩
+} PostingList;
+
+// űα
+typedef struct {
+    const PostingList* list;
+    int pos;                     // ǰֽλ
+    int docId;                   // ǰ¼ID
+    int termFreq;                // ǰ¼ĴƵ
+} PostingCursor;
+
+// ȫݵĵ
+typedef struct {
+    PostingList* terms;          // ʱѰַϣ
+    int termCapacity;            // ʱ
+    int termCount;               // ʱеĴ
+    int* docLength;              // docLength[id]۵Ĵ0ʾδ¼-1ʾɾ
+    char** staleTerms;           // staleTerms[id]ɾùĴʣ'\0'ָմβ
+    int docCapacity;             // docLengthstaleTerms
+    int docCount;                // ǰ¼
+    long long totalLength;       // ¼۵Ĵ֮ͣڼƽȣ
+    long long livePostings;      // Чĵż¼
+    long long deadPostings;      // ɾ۲ĵż¼
+} SearchIndex;
+
+// ҳȾԤȷ䣬ÿҳã
+typedef struct {
+    char* data;
+    int size;
+    int capacity;
+} PageBuffer;
+
+// еĺѡ
+typedef struct {
+    int id;
+    double score;
+} SearchHit;
+
+// ͳƵĲ
+typedef enum {
+    METRIC_ADD_REPLY,            // addReply
+    METRIC_FIND,                 // findCommentInSystem
+    METRIC_DELETE,               // deleteCommentFromSystem
+    METRIC_LIKE,                 // likeComment / likeCommentById
+    METRIC_LIKE_BATCH,           // flushLikeBuffer޺͵޻ÿκϲд룩
+    METRIC_OP_COUNT
+} MetricOperation;
+
+// ĵôӳֱͼ
+typedef struct {
+    long long count;             // ôÿζͳƣ
+    long long sampled;           // ʱĴLATENCY_SAMPLE_RATE
+    long long totalNanos;
+    long long maxNanos;
+    long long buckets[LATENCY_BUCKETS];
+} OperationStats;
+
+// ߵдͳ
+typedef struct {
+    char author[MAX_AUTHOR_LEN]; // ַʾղ
+    long long writes;            // д + ظ
+    time_t firstWrite;
+    time_t windowStart;          // ǰһӴڵĿʼʱ
+    int windowWrites;            // ǰڵд
+    int peakPerMinute;           // ʷߵÿд
+} AuthorStats;
+
+// ޻ÿ߳һͬһ۵ĵڻȺϲɼһд
+typedef struct {
+    int* ids;                    // Ѱַϣ0ʾղ
+    int* counts;                 // counts[i]ids[i]µĵ
+    int capacity;
+    int distinct;                // вͬ۵
+    int pending;                 // еĵ
+} LikeBuffer;
+
+// ϵͳͳƣÿ߳һݣ
+typedef struct {
+    OperationStats operations[METRIC_OP_COUNT];
+    AuthorStats* authors;        // ͳƱѰַϣ
+    int authorCount;
+    int authorCapacity;
+} CommentMetrics;
+
+// жıǷΪϷUTF-8GBK
+int isUtf8Text(const char* text) {
+    const unsigned char* s = (const unsigned char*)text;
+    while (*s) {
+        int len;
+        if (*s < 0x80) len = 1;
+        else if ((*s & 0xE0) == 0xC0) len = 2;
+        else if ((*s & 0xF0) == 0xE0) len = 3;
+        else if ((*s & 0xF8) == 0xF0) len = 4;
+        else return 0;
+
+        for (int i = 1; i < len; i++) {
+            if ((s[i] & 0xC0) != 0x80) return 0;
+        }
+        s += len;
+    }
+    return 1;
+}
+
+// شsʼһַռõֽ
+int getCharLength(const unsigned char* s, int utf8) {
+    if (*s < 0x80) return 1;
+    if (utf8) {
+        if ((*s & 0xE0) == 0xC0) return 2;
+        if ((*s & 0xF0) == 0xE0) return 3;
+        return 4;
+    }
+    return (s[1] != 0) ? 2 : 1;  // GBK˫ַֽ
+}
+
+// һڣַƴ׷ӵʱ
+void appendToken(char tokens[][MAX_TOKEN_LEN], int* count, int maxTokens,
+                 const unsigned char* first, int firstLen,
+                 const unsigned char* second, int secondLen) {
+    if (*count >= maxTokens || firstLen + secondLen >= MAX_TOKEN_LEN) return;
+
+    memcpy(tokens[*count], first, firstLen);
+    if (second != NULL) {
+        memcpy(tokens[*count] + firstLen, second, secondLen);
+    }
+    tokens[*count][firstLen + secondLen] = '\0';
+    (*count)++;
+}
+
+// зıӢĺְʣתСдĵȶַֺֽ˫֣n-gram
+// forQueryΪ1ʱֽڴֻȡ˫֣һʱȡ֣Ҫϲĵű
+int tokenizeText(const char* text, char tokens[][MAX_TOKEN_LEN], int maxTokens, int forQuery) {
+    const unsigned char* s = (const unsigned char*)text;
+    int utf8 = isUtf8Text(text);
+    int count = 0;
+
+    unsigned char word[MAX_TOKEN_LEN];
+    int wordLen = 0;
+    const unsigned char* prevChar = NULL;  // ֽڴеһַ
+    int prevLen = 0;
+    int runLength = 0;                     // ǰֽڴַ
+
+    while (1) {
+        int len = (*s == 0) ? 0 : getCharLength(s, utf8);
+
+        // ASCIIַıǰĶֽڴ
+        if (len <= 1 && runLength > 0) {
+            if (forQuery && runLength == 1) {
+                appendToken(tokens, &count, maxTokens, prevChar, prevLen, NULL, 0);
+            }
+            prevChar = NULL;
+            runLength = 0;
+        }
+
+        // ĸֻıǰ
+        if ((len != 1 || !isalnum(*s)) && wordLen > 0) {
+            appendToken(tokens, &count, maxTokens, word, wordLen, NULL, 0);
+            wordLen = 0;
+        }
+
+        if (len == 0) break;
+
+        if (len == 1) {
+            if (isalnum(*s) && wordLen < MAX_TOKEN_LEN - 1) {
+                word[wordLen++] = (unsigned char)tolower(*s);  // ĵʽض
+            }
+        } else {
+            if (!forQuery) {
+                appendToken(tokens, &count, maxTokens, s, len, NULL, 0);
+            }
+            if (prevChar != NULL) {
+                appendToken(tokens, &count, maxTokens, prevChar, prevLen, s, len);
+            }
+            prevChar = s;
+            prevLen = len;
+            runLength++;
+        }
+        s += len;
+    }
+
+    return count;
+}
+
+// 䳤ֽڱ룺ÿֽڵ7λݣλΪ1ʾ滹ֽ
+int encodeVarint(unsigned char* out, unsigned int value) {
+    int len = 0;
+    while (value >= 0x80) {
+        out[len++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    out[len++] = (unsigned char)value;
+    return len;
+}
+
+// 䳤ֽڽ룬posǰһֵ
+unsigned int decodeVarint(const unsigned char* data, int* pos) {
+    unsigned int value = 0;
+    int shift = 0;
+    while (data[*pos] & 0x80) {
+        value |= (unsigned int)(data[(*pos)++] & 0x7F) << shift;
+        shift += 7;
+    }
+    value |= (unsigned int)data[(*pos)++] << shift;
+    return value;
+}
+
+// ȡűһ¼귵0
+int nextPosting(PostingCursor* cursor) {
+    if (cursor->pos >= cursor->list->size) return 0;
+
+    cursor->docId += (int)decodeVarint(cursor->list->data, &cursor->pos);
+    cursor->termFreq = (int)decodeVarint(cursor->list->data, &cursor->pos);
+    return 1;
+}
+
+// ͷʼű
+void startPostingCursor(PostingCursor* cursor, const PostingList* list) {
+    cursor->list = list;
+    cursor->pos = 0;
+    cursor->docId = 0;
+    cursor->termFreq = 0;
+}
+
+// ڵűĩβ׷һIDڱеID
+int appendPosting(PostingList* list, int docId, int termFreq) {
+    // varint10ֽ
+    if (list->size + 10 > list->capacity) {
+        int newCapacity = (list->capacity == 0) ? 16 : list->capacity * 2;
+        unsigned char* newData = (unsigned char*)realloc(list->data, newCapacity);
+        if (newData == NULL) {
+            printf("ڴչʧܣ\n");
+            return 0;
+        }
+        list->data = newData;
+        list->capacity = newCapacity;
+    }
+
+    list->size += encodeVarint(list->data + list->size, (unsigned int)(docId - list->lastDocId));
+    list->size += encodeVarint(list->data + list->size, (unsigned int)termFreq);
+    list->lastDocId = docId;
+    list->docFreq++;
+    return 1;
+}
+
+// дűkeepDocLengthΪNULLʱɾۣinsertId>0ʱ˳һ¼¼
+int rewritePosting(PostingList* list, const int* docLength, int insertId, int insertFreq) {
+    int total = list->docFreq + 1;
+    int* ids = (int*)malloc(total * sizeof(int));
+    int* freqs = (int*)malloc(total * sizeof(int));
+    if (ids == NULL || freqs == NULL) {
+        printf("ڴʧܣ\n");
+        free(ids);
+        free(freqs);
+        return 0;
+    }
+
+    // м¼
+    int n = 0;
+    PostingCursor cursor;
+    startPostingCursor(&cursor, list);
+    while (nextPosting(&cursor)) {
+        if (docLength != NULL && docLength[cursor.docId] <= 0) continue;
+        if (insertId > 0 && insertId < cursor.docId) {
+            ids[n] = insertId;
+            freqs[n++] = insertFreq;
+            insertId = 0;
+        }
+        ids[n] = cursor.docId;
+        freqs[n++] = cursor.termFreq;
+    }
+    if (insertId > 0) {
+        ids[n] = insertId;
+        freqs[n++] = insertFreq;
+    }
+
+    // ±루ֻٻһԭ㹻ô󲿷ֿռ䣩
+    list->size = 0;
+    list->lastDocId = 0;
+    list->docFreq = 0;
+    int ok = 1;
+    for (int i = 0; i < n && ok; i++) {
+        ok = appendPosting(list, ids[i], freqs[i]);
+    }
+
+    free(ids);
+    free(freqs);
+    return ok;
+}
+
+// FNV-1a ַϣ
+unsigned int hashToken(const char* token) {
+    unsigned int hash = 2166136261u;
+    while (*token) {
+        hash ^= (unsigned char)*token++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// ڴʱвʣڷNULL
+PostingList* findTerm(SearchIndex* index, const char* token) {
+    if (index->termCapacity == 0) return NULL;
+
+    unsigned int mask = (unsigned int)index->termCapacity - 1;
+    unsigned int slot = hashToken(token) & mask;
+    while (index->terms[slot].token[0] != '\0') {
+        if (strcmp(index->terms[slot].token, token) == 0) {
+            return &index->terms[slot];
+        }
+        slot = (slot + 1) & mask;  // ̽
+    }
+    return NULL;
+}
+
+// ʱݣʼ2ݣ
+int growTermTable(SearchIndex* index) {
+    int newCapacity = (index->termCapacity == 0) ?
+                      INIT_TERM_CAPACITY :
+                      index->termCapacity * 2;
+    PostingList* newTerms = (PostingList*)calloc(newCapacity, sizeof(PostingList));
+    if (newTerms == NULL) {
+        printf("ڴʧܣ\n");
+        return 0;
+    }
+
+    unsigned int mask = (unsigned int)newCapacity - 1;
+    for (int i = 0; i < index->termCapacity; i++) {
+        if (index->terms[i].token[0] == '\0') continue;
+        unsigned int slot = hashToken(index->terms[i].token) & mask;
+        while (newTerms[slot].token[0] != '\0') {
+            slot = (slot + 1) & mask;
+        }
+        newTerms[slot] = index->terms[i];
+    }
+
+    free(index->terms);
+    index->terms = newTerms;
+    index->termCapacity = newCapacity;
+    return 1;
+}
+
+// ʣ½
+PostingList* findOrAddTerm(SearchIndex* index, const char* token) {
+    PostingList* list = findTerm(index, token);
+    if (list != NULL) return list;
+
+    // װʳ70%ʱ
+    if ((index->termCount + 1) * 10 > index->termCapacity * 7) {
+        if (!growTermTable(index)) return NULL;
+    }
+
+    unsigned int mask = (unsigned int)index->termCapacity - 1;
+    unsigned int slot = hashToken(token) & mask;
+    while (index->terms[slot].token[0] != '\0') {
+        slot = (slot + 1) & mask;
+    }
+    strcpy(index->terms[slot].token, token);
+    index->termCount++;
+    return &index->terms[slot];
+}
+
+// ʼȫ
+void initSearchIndex(SearchIndex* index) {
+    index->terms = NULL;
+    index->termCapacity = 0;
+    index->termCount = 0;
+    index->docLength = NULL;
+    index->staleTerms = NULL;
+    index->docCapacity = 0;
+    index->docCount = 0;
+    index->totalLength = 0;
+    index->livePostings = 0;
+    index->deadPostings = 0;
+}
+
+// ͷȫ
+void freeSearchIndex(SearchIndex* index) {
+    for (int i = 0; i < index->termCapacity; i++) {
+        free(index->terms[i].data);
+    }
+    free(index->terms);
+    for (int id = 0; id < index->docCapacity; id++) {
+        free(index->staleTerms[id]);
+    }
+    free(index->docLength);
+    free(index->staleTerms);
+    initSearchIndex(index);
+}
+
+// űɾ۵Ĳ¼
+void purgeSearchIndex(SearchIndex* index) {
+    for (int i = 0; i < index->termCapacity; i++) {
+        if (index->terms[i].docFreq > 0) {
+            rewritePosting(&index->terms[i], index->docLength, 0, 0);
+        }
+    }
+    for (int id = 0; id < index->docCapacity; id++) {
+        if (index->docLength[id] < 0) {
+            index->docLength[id] = 0;
+            free(index->staleTerms[id]);
+            index->staleTerms[id] = NULL;
+        }
+    }
+    index->deadPostings = 0;
+}
+
+// ɾùĴʣtokensظֻһΣͬһID¼ʱֻЩʵĵű
+// ڴ治㷵0ʱ¼ֻ
+int recordStaleTerms(SearchIndex* index, int id, char tokens[][MAX_TOKEN_LEN], int tokenCount) {
+    int size = 1;
+    for (int i = 0; i < tokenCount; i++) {
+        if (i == 0 || strcmp(tokens[i], tokens[i - 1]) != 0) size += strlen(tokens[i]) + 1;
+    }
+    char* terms = (char*)malloc(size);
+    if (terms == NULL) return 0;
+
+    int pos = 0;
+    for (int i = 0; i < tokenCount; i++) {
+        if (i > 0 && strcmp(tokens[i], tokens[i - 1]) == 0) continue;
+        strcpy(terms + pos, tokens[i]);
+        pos += strlen(tokens[i]) + 1;
+    }
+    terms[pos] = '\0';
+    free(index->staleTerms[id]);
+    index->staleTerms[id] = terms;
+    return 1;
+}
+
+// ͬһIDɾ¼룺ֻдùĴʵĵűȥɾ۵Ĳ¼
+int dropStalePostings(SearchIndex* index, int id) {
+    char* terms = index->staleTerms[id];
+    if (terms == NULL) {
+        purgeSearchIndex(index);  // ɾʱûܼùĴʣڴ治㣩
+        return 1;
+    }
+
+    for (char* token = terms; *token != '\0'; token += strlen(token) + 1) {
+        PostingList* list = findTerm(index, token);
+        if (list == NULL || list->docFreq == 0) continue;
+        int before = list->docFreq;
+        if (!rewritePosting(list, index->docLength, 0, 0)) return 0;
+        index->deadPostings -= before - list->docFreq;  // ˳ɾ۵ļ¼
+    }
+    free(terms);
+    index->staleTerms[id] = NULL;
+    index->docLength[id] = 0;
+    return 1;
+}
+
+// Ƚʣqsort
+int compareTokens(const void* a, const void* b) {
+    return strcmp((const char*)a, (const char*)b);
+}
+
+// ۼȫ
+int indexComment(SearchIndex* index, CommentNode* comment) {
+    int id = comment->id;
+
+    // ĵ鰴
+    if (id >= index->docCapacity) {
+        int newCapacity = (index->docCapacity == 0) ?
+                          INIT_ID_INDEX_CAPACITY :
+                          index->docCapacity;
+        while (newCapacity <= id) {
+            newCapacity *= 2;
+        }
+        int* newLength = (int*)realloc(index->docLength, newCapacity * sizeof(int));
+        if (newLength == NULL) {
+            printf("ڴչʧܣ\n");
+            return 0;
+        }
+        index->docLength = newLength;
+        char** newStale = (char**)realloc(index->staleTerms, newCapacity * sizeof(char*));
+        if (newStale == NULL) {
+            printf("ڴչʧܣ\n");
+            return 0;
+        }
+        index->staleTerms = newStale;
+        memset(newLength + index->docCapacity, 0,
+               (newCapacity - index->docCapacity) * sizeof(int));
+        memset(newStale + index->docCapacity, 0,
+               (newCapacity - index->docCapacity) * sizeof(char*));
+        index->docCapacity = newCapacity;
+    }
+
+    if (index->docLength[id] > 0) return 1;      // Ѿ¼
+    if (index->docLength[id] < 0 && !dropStalePostings(index, id)) return 0;
+
+    char tokens[MAX_TOKENS_PER_TEXT][MAX_TOKEN_LEN];
+    int tokenCount = tokenizeText(comment->content, tokens, MAX_TOKENS_PER_TEXT, 0);
+    if (tokenCount == 0) return 1;
+
+    // ͬĴڣ˳ͳƴƵ
+    qsort(tokens, tokenCount, MAX_TOKEN_LEN, compareTokens);
+    int uniqueDone = 0;
+    for (int i = 0; i < tokenCount; ) {
+        int j = i + 1;
+        while (j < tokenCount && strcmp(tokens[i], tokens[j]) == 0) j++;
+
+        PostingList* list = findOrAddTerm(index, tokens[i]);
+        int ok = (list != NULL);
+        if (ok && id > list->lastDocId) {
+            ok = appendPosting(list, id, j - i);
+        } else if (ok) {
+            ok = rewritePosting(list, NULL, id, j - i);  // IDǵģ룩˳
+        }
+        if (!ok) {
+            // Ѿдļ¼ɾѯʱ¼ʱ
+            index->docLength[id] = -1;
+            index->livePostings -= uniqueDone;
+            index->deadPostings += uniqueDone;
+            recordStaleTerms(index, id, tokens, i);
+            return 0;
+        }
+        uniqueDone++;
+        index->livePostings++;
+        i = j;
+    }
+
+    index->docLength[id] = tokenCount;
+    index->docCount++;
+    index->totalLength += tokenCount;
+    return 1;
+}
+
+// ۴ȫƳűеļ¼ӳ
+void unindexComment(SearchIndex* index, CommentNode* comment) {
+    int id = comment->id;
+    if (id <= 0 || id >= index->docCapacity || index->docLength[id] <= 0) return;
+
+    // ͳƸռõĵż¼
+    char tokens[MAX_TOKENS_PER_TEXT][MAX_TOKEN_LEN];
+    int tokenCount = tokenizeText(comment->content, tokens, MAX_TOKENS_PER_TEXT, 0);
+    qsort(tokens, tokenCount, MAX_TOKEN_LEN, compareTokens);
+    int uniqueCount = 0;
+    for (int i = 0; i < tokenCount; i++) {
+        if (i == 0 || strcmp(tokens[i], tokens[i - 1]) != 0) uniqueCount++;
+    }
+
+    index->totalLength -= index->docLength[id];
+    index->docLength[id] = -1;  // Ϊɾ
+    recordStaleTerms(index, id, tokens, tokenCount);
+    index->docCount--;
+    index->livePostings -= uniqueCount;
+    index->deadPostings += uniqueCount;
+
+    // ¼Ч¼ʱһ
+    if (index->deadPostings > index->livePostings) {
+        purgeSearchIndex(index);
+    }
+}
+
+// BM25ʵĵƵʣÿѯһΣ
+double bm25Idf(SearchIndex* index, int docFreq) {
+    double n = index->docCount;
+    return log(1.0 + (n - docFreq + 0.5) / (docFreq + 0.5));
+}
+
+// BM25ʶһ۵ضȵ÷
+double bm25Score(SearchIndex* index, double idf, int termFreq, int docLength) {
+    double avgLength = (index->docCount > 0) ?
+                       (double)index->totalLength / index->docCount : 1.0;
+    double norm = termFreq + 1.2 * (0.25 + 0.75 * docLength / avgLength);
+    return idf * termFreq * 2.2 / norm;
+}
+#if ENABLE_METRICS
+static _Thread_local CommentMetrics metrics;  // ǰ̵߳ͳͰ
+
+// ǰʱ䣨룬ֻڼʱ
+long long currentNanos() {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+// ͳһεãҪʱʱؿʼʱ䣬򷵻0
+long long beginOperation(MetricOperation operation) {
+    OperationStats* stats = &metrics.operations[operation];
+    if ((stats->count++ & (LATENCY_SAMPLE_RATE - 1)) != 0) return 0;
+    return currentNanos();
+}
+
+// ¼һγĺʱ
+void recordLatency(MetricOperation operation, long long nanos) {
+    OperationStats* stats = &metrics.operations[operation];
+    int bucket = 0;
+    while (bucket < LATENCY_BUCKETS - 1 && (nanos >> (bucket + 1)) > 0) {
+        bucket++;
+    }
+
+    stats->sampled++;
+    stats->totalNanos += nanos;
+    if (nanos > stats->maxNanos) stats->maxNanos = nanos;
+    stats->buckets[bucket]++;
+}
+
+// ͳƱݣ²룩
+int growAuthorStats() {
+    int newCapacity = (metrics.authorCapacity == 0) ?
+                      INIT_AUTHOR_STAT_CAPACITY : metrics.authorCapacity * 2;
+    AuthorStats* newAuthors = (AuthorStats*)calloc(newCapacity, sizeof(AuthorStats));
+    if (newAuthors == NULL) return 0;
+
+    unsigned int mask = newCapacity - 1;
+    for (int i = 0; i < metrics.authorCapacity; i++) {
+        if (metrics.authors[i].author[0] == '\0') continue;
+        unsigned int slot = hashToken(metrics.authors[i].author) & mask;
+        while (newAuthors[slot].author[0] != '\0') {
+            slot = (slot + 1) & mask;
+        }
+        newAuthors[slot] = metrics.authors[i];
+    }
+
+    free(metrics.authors);
+    metrics.authors = newAuthors;
+    metrics.authorCapacity = newCapacity;
+    return 1;
+}
+
+// ¼һд루һӴͳдʣ
+void recordAuthorWrite(const char* author) {
+    if (author[0] == '\0') return;
+    if ((metrics.authorCount + 1) * 4 > metrics.authorCapacity * 3 && !growAuthorStats()) {
+        return;  // ͳƱ޷ʱͳƣӰ۲
+    }
+
+    unsigned int mask = metrics.authorCapacity - 1;
+    unsigned int slot = hashToken(author) & mask;
+    while (metrics.authors[slot].author[0] != '\0' &&
+           strcmp(metrics.authors[slot].author, author) != 0) {
+        slot = (slot + 1) & mask;
+    }
+
+    AuthorStats* stats = &metrics.authors[slot];
+    time_t now = time(NULL);
+    if (stats->author[0] == '\0') {
+        strcpy(stats->author, author);
+        stats->firstWrite = now;
+        stats->windowStart = now;
+        metrics.authorCount++;
+    }
+    if (now - stats->windowStart >= 60) {
+        stats->windowStart = now;
+        stats->windowWrites = 0;
+    }
+
+    stats->writes++;
+    stats->windowWrites++;
+    if (stats->windowWrites > stats->peakPerMinute) {
+        stats->peakPerMinute = stats->windowWrites;
+    }
+}
+
+// ֱͼٷλӳ٣ͰϽ磩
+long long latencyPercentile(const OperationStats* stats, double percent) {
+    long long target = (long long)(stats->sampled * percent / 100.0);
+    long long seen = 0;
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += stats->buckets[i];
+        if (seen > target) {
+            long long upper = 1LL << (i + 1);
+            return (upper < stats->maxNanos) ? upper : stats->maxNanos;
+        }
+    }
+    return stats->maxNanos;
+}
+
+// ͳƲͷͳƱ
+void resetMetrics() {
+    free(metrics.authors);
+    memset(&metrics, 0, sizeof(metrics));
+}
+
+#define METRIC_START(operation, name) long long name = beginOperation(operation)
+#define METRIC_STOP(operation, name) \
+    do { if ((name) != 0) recordLatency(operation, currentNanos() - (name)); } while (0)
+#define METRIC_AUTHOR_WRITE(author) recordAuthorWrite(author)
+#else
+#define METRIC_START(operation, name)
+#define METRIC_STOP(operation, name)
+#define METRIC_AUTHOR_WRITE(author)
+void resetMetrics() {}
+#endif
+
+// ıʽǰ̵߳ͳƣĻļ
+void dumpMetrics(FILE* out) {
+#if ENABLE_METRICS
+    static const char* names[METRIC_OP_COUNT] = {
+        "addReply", "findCommentInSystem", "deleteCommentFromSystem", "likeComment",
+        "flushLikeBuffer"
+    };
+
+    fprintf(out, "========== ͳ ==========\n");
+    fprintf(out, "%-24s %10s %10s %10s %10s %10s\n",
+            "", "", "ƽ(ns)", "P50(ns)", "P99(ns)", "(ns)");
+    for (int op = 0; op < METRIC_OP_COUNT; op++) {
+        const OperationStats* stats = &metrics.operations[op];
+        fprintf(out, "%-24s %10lld %10lld %10lld %10lld %10lld\n",
+                names[op], stats->count,
+                (stats->sampled > 0) ? stats->totalNanos / stats->sampled : 0,
+                (stats->sampled > 0) ? latencyPercentile(stats, 50) : 0,
+                (stats->sampled > 0) ? latencyPercentile(stats, 99) : 0,
+                stats->maxNanos);
+    }
+
+    fprintf(out, "ӳٷֲÿ %d εóһΣ½ns: \n", LATENCY_SAMPLE_RATE);
+    for (int op = 0; op < METRIC_OP_COUNT; op++) {
+        const OperationStats* stats = &metrics.operations[op];
+        if (stats->sampled == 0) continue;
+        fprintf(out, "  %s:", names[op]);
+        for (int i = 0; i < LATENCY_BUCKETS; i++) {
+            if (stats->buckets[i] > 0) {
+                fprintf(out, " %lld:%lld", (i == 0) ? 0 : 1LL << i, stats->buckets[i]);
+            }
+        }
+        fprintf(out, "\n");
+    }
+
+    // дߣÿѡʣһ϶ʱҲֻɨTOP_AUTHOR_COUNT
+    fprintf(out, "дߣ %d λ\n", metrics.authorCount);
+    long long lastWrites = -1;
+    int lastSlot = -1;
+    time_t now = time(NULL);
+    for (int rank = 0; rank < TOP_AUTHOR_COUNT && rank < metrics.authorCount; rank++) {
+        int best = -1;
+        for (int i = 0; i < metrics.authorCapacity; i++) {
+            const AuthorStats* stats = &metrics.authors[i];
+            if (stats->author[0] == '\0') continue;
+            // (д, λ)ţѾ
+            if (lastWrites >= 0 && (stats->writes > lastWrites ||
+                (stats->writes == lastWrites && i <= lastSlot))) continue;
+            if (best < 0 || stats->writes > metrics.authors[best].writes) best = i;
+        }
+        if (best < 0) break;
+
+        const AuthorStats* stats = &metrics.authors[best];
+        double minutes = (now - stats->firstWrite) / 60.0;
+        fprintf(out, "  %-20s д %lld Σƽ %.1f /ӣֵ %d /\n",
+                stats->author, stats->writes,
+                (minutes >= 1.0) ? stats->writes / minutes : (double)stats->writes,
+                stats->peakPerMinute);
+        lastWrites = stats->writes;
+        lastSlot = best;
+    }
+    fprintf(out, "==============================\n");
+#else
+    fprintf(out, "ͳδʱʹ -DENABLE_METRICS=1 \n");
+#endif
+}
+
 // ϵͳṹ壨ۣ
 typedef struct {
     CommentNode** rootComments;  // 飨ɭ֣
     int rootCount;               // 
     int rootCapacity;            // 
+    int rootDeletedCount;        // rootCommentsеĿλĹ
+    CommentNode** idIndex;       // IDidIndex[id]ָӦۣΪNULL
+    int idCapacity;              // ID
+    SearchIndex searchIndex;     // ݵȫ
     int nextId;                  // һõID
 } CommentSystem;
 // µ۽ڵ
+// ݺ߰ʵʳȴڽڵ֮free(node)һͷţ
+// ÿҪռ600ֽڣ10^7Ҫ6GBϣ䳤źÿԼΪ96ֽڼı
 CommentNode* createCommentNode(int id, char* content, char* author) {
-    CommentNode* node = (CommentNode*)malloc(sizeof(CommentNode));
+    size_t contentLen = strlen(content) + 1;
+    size_t authorLen = strlen(author) + 1;
+    CommentNode* node = (CommentNode*)malloc(sizeof(CommentNode) + contentLen + authorLen);
     if (node == NULL) {
         printf("ڴʧܣ\n");
         return NULL;
@@ -54,8 +882,10 @@ CommentNode* createCommentNode(int id, char* content, char* author) {
 
     // ʼֶ
     node->id = id;
-    strcpy(node->content, content);
-    strcpy(node->author, author);
+    node->content = (char*)(node + 1);
+    memcpy(node->content, content, contentLen);
+    node->author = node->content + contentLen;
+    memcpy(node->author, author, authorLen);
     node->timestamp = time(NULL);
     node->likeCount = 0;
 
@@ -64,15 +894,18 @@ CommentNode* createCommentNode(int id, char* content, char* author) {
     node->children = NULL;
     node->childCount = 0;
     node->childCapacity = 0;
+    node->deletedChildCount = 0;
+    node->descendantCount = 0;
+    node->slotIndex = -1;
+    node->frozen = NULL;
     node->depth = 0;
 
     return node;
 }
-// ӻظӹϵ
-int addReply(CommentNode* parent, CommentNode* reply) {
+// ӹϵʾɹ1Ʒ0ڴ治㷵-1
+int attachReply(CommentNode* parent, CommentNode* reply) {
     // 
     if (parent->depth >= MAX_DEPTH) {
-        printf("Ƕȣ%d㣩޷ӻظ\n", MAX_DEPTH);
         return 0;
     }
 
@@ -89,7 +922,7 @@ int addReply(CommentNode* parent, CommentNode* reply) {
 
         if (newChildren == NULL) {
             printf("ڴչʧܣ\n");
-            return 0;
+            return -1;
         }
 
         parent->children = newChildren;
@@ -98,13 +931,34 @@ int addReply(CommentNode* parent, CommentNode* reply) {
 
     // ӹϵ
     parent->children[parent->childCount] = reply;
+    reply->slotIndex = parent->childCount;
     reply->parent = parent;
     reply->depth = parent->depth + 1;
     parent->childCount++;
 
-    printf("ظӳɹ\n");
+    // ȵĻظȲMAX_DEPTHΪ
+    for (CommentNode* ancestor = parent; ancestor != NULL; ancestor = ancestor->parent) {
+        ancestor->descendantCount += 1 + reply->descendantCount;
+    }
+
     return 1;
 }
+// ӻظӹϵ
+int addReply(CommentNode* parent, CommentNode* reply) {
+    METRIC_START(METRIC_ADD_REPLY, startNanos);
+    int result = attachReply(parent, reply);
+    METRIC_STOP(METRIC_ADD_REPLY, startNanos);
+    if (result > 0) {
+        METRIC_AUTHOR_WRITE(reply->author);
+    }
+
+    if (result == 0) {
+        printf("Ƕȣ%d㣩޷ӻظ\n", MAX_DEPTH);
+    } else if (result > 0) {
+        printf("ظӳɹ\n");
+    }
+    return result > 0;
+}
 // в
 /*int main() {
     CommentNode* mainComment = createCommentNode(1, "", "ûA");
@@ -123,11 +977,103 @@ void initCommentSystem(CommentSystem* system) {
     system->rootComments = NULL;
     system->rootCount = 0;
     system->rootCapacity = 0;
+    system->rootDeletedCount = 0;
+    system->idIndex = NULL;
+    system->idCapacity = 0;
+    initSearchIndex(&system->searchIndex);
     system->nextId = 1;
 }
 
-// 
-int addRootComment(CommentSystem* system, CommentNode* comment) {
+// IDеǼۣIDֱΪ±꣬ʱݣ
+int registerComment(CommentSystem* system, CommentNode* comment) {
+    if (comment->id <= 0) {
+        printf("ЧID%d\n", comment->id);
+        return 0;
+    }
+
+    if (comment->id >= system->idCapacity) {
+        int newCapacity = (system->idCapacity == 0) ?
+                          INIT_ID_INDEX_CAPACITY :
+                          system->idCapacity;
+        while (newCapacity <= comment->id) {
+            newCapacity *= 2;
+        }
+
+        CommentNode** newIndex = (CommentNode**)realloc(
+            system->idIndex,
+            newCapacity * sizeof(CommentNode*)
+        );
+
+        if (newIndex == NULL) {
+            printf("ڴչʧܣ\n");
+            return 0;
+        }
+
+        // Ĳ
+        memset(newIndex + system->idCapacity, 0,
+               (newCapacity - system->idCapacity) * sizeof(CommentNode*));
+        system->idIndex = newIndex;
+        system->idCapacity = newCapacity;
+    }
+
+    // ȫʧʱIDĵǼǣѲ
+    CommentNode* previous = system->idIndex[comment->id];
+    system->idIndex[comment->id] = comment;
+    if (!indexComment(&system->searchIndex, comment)) {
+        system->idIndex[comment->id] = previous;
+        return 0;
+    }
+    return 1;
+}
+
+// IDע
+void unregisterSubtree(CommentSystem* system, CommentNode* node) {
+    if (node == NULL) return;
+
+    if (node->id > 0 && node->id < system->idCapacity) {
+        system->idIndex[node->id] = NULL;
+    }
+    unindexComment(&system->searchIndex, node);
+
+    for (int i = 0; i < node->childCount; i++) {
+        unregisterSubtree(system, node->children[i]);
+    }
+}
+
+// ѹλ飺ȥĹλԭ˳򲢸slotIndex
+void compactSlots(CommentNode** slots, int* count, int* deletedCount) {
+    int write = 0;
+    for (int read = 0; read < *count; read++) {
+        if (slots[read] != NULL) {
+            slots[write] = slots[read];
+            slots[write]->slotIndex = write;
+            write++;
+        }
+    }
+    *count = write;
+    *deletedCount = 0;
+}
+
+// ĳλΪĹҪʱβѹ̯O(1)
+void tombstoneSlot(CommentNode** slots, int* count, int* deletedCount, int index) {
+    slots[index]->slotIndex = -1;
+    slots[index] = NULL;
+    (*deletedCount)++;
+
+    // βĿλֱӶ
+    while (*count > 0 && slots[*count - 1] == NULL) {
+        (*count)--;
+        (*deletedCount)--;
+    }
+
+    // λһʱѹһ
+    if (*deletedCount * 2 > *count) {
+        compactSlots(slots, count, deletedCount);
+    }
+}
+
+// ۹ҵ飨ʾ
+int attachRootComment(CommentSystem* system, CommentNode* comment) {
     // ǷҪչ
     if (system->rootCount >= system->rootCapacity) {
         int newCapacity = (system->rootCapacity == 0) ?
@@ -148,21 +1094,231 @@ int addRootComment(CommentSystem* system, CommentNode* comment) {
         system->rootCapacity = newCapacity;
     }
 
+    // ǼǵID
+    if (!registerComment(system, comment)) {
+        return 0;
+    }
+
     // ȷ
     comment->parent = NULL;
     comment->depth = 0;
 
     // ӵ
     system->rootComments[system->rootCount] = comment;
+    comment->slotIndex = system->rootCount;
     system->rootCount++;
 
+    return 1;
+}
+// 
+int addRootComment(CommentSystem* system, CommentNode* comment) {
+    if (!attachRootComment(system, comment)) {
+        return 0;
+    }
+    METRIC_AUTHOR_WRITE(comment->author);
+
     printf("ӳɹ\n");
     return 1;
 }
+// ϵͳӻظͬʱǼǵID
+int addReplyToSystem(CommentSystem* system, CommentNode* parent, CommentNode* reply) {
+    if (!registerComment(system, reply)) {
+        return 0;
+    }
+
+    if (!addReply(parent, reply)) {
+        unregisterSubtree(system, reply);
+        return 0;
+    }
+
+    return 1;
+}
+
+// ǰɾĿλ
+int getRootCommentCount(CommentSystem* system) {
+    return system->rootCount - system->rootDeletedCount;
+}
+// ͷŶ¥
+void freeFrozenThread(FrozenThread* thread) {
+    if (thread == NULL) return;
+
+    free(thread->nodes);
+    free(thread->idOrder);
+    free(thread->authors);
+    free(thread->contents);
+    free(thread);
+}
+
+// ڶ¥аIDֲңǰ±꣬Ҳ-1
+int findFrozenOffset(FrozenThread* thread, int id) {
+    int low = 0, high = thread->nodeCount - 1;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        if (thread->idOrder[mid].id == id) return thread->idOrder[mid].offset;
+        if (thread->idOrder[mid].id < id) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return -1;
+}
+
+// ʾ¥offsetΪǰ˳ʾ˳ݹ飩
+void displayFrozenComment(FrozenThread* thread, int offset, int indent) {
+    int end = offset + thread->nodes[offset].subtreeSize;
+    int baseDepth = thread->nodes[offset].depth;
+
+    for (int i = offset; i < end; i++) {
+        FrozenComment* comment = &thread->nodes[i];
+        printf("%*s[%s] %s (: %d, ID: %d)\n",
+               (indent + comment->depth - baseDepth) * 2, "",
+               thread->authors + comment->authorOffset,
+               thread->contents + comment->contentOffset,
+               comment->likeCount,
+               comment->id);
+    }
+}
+
+// ڶ¥вĳߵۣλһΣֻ֮Ƚƫ
+void findFrozenCommentsByAuthor(FrozenThread* thread, const char* author,
+                                int* offsets, int* count, int maxResults) {
+    int authorOffset = -1;
+    for (int pos = 0; pos < thread->authorsSize; pos += strlen(thread->authors + pos) + 1) {
+        if (strcmp(thread->authors + pos, author) == 0) {
+            authorOffset = pos;
+            break;
+        }
+    }
+    if (authorOffset < 0) return;
+
+    for (int i = 0; i < thread->nodeCount && *count < maxResults; i++) {
+        if (thread->nodes[i].authorOffset == authorOffset) {
+            offsets[(*count)++] = i;
+        }
+    }
+}
+
+// ⶳѶ¥ԭָظɾȽṹ޸ǰãֱӸĽ飬ⶳ
+int thawThread(CommentSystem* system, CommentNode* root) {
+    FrozenThread* thread = root->frozen;
+    int nodeCount = thread->nodeCount;
+
+    CommentNode** nodes = (CommentNode**)malloc(nodeCount * sizeof(CommentNode*));
+    int* childTotals = (int*)calloc(nodeCount, sizeof(int));
+    if (nodes == NULL || childTotals == NULL) {
+        printf("ڴʧܣ\n");
+        free(nodes);
+        free(childTotals);
+        return 0;
+    }
+
+    // ǰÿڵֱӻظÿڵĸڵһֵĽڵ
+    int parentAtDepth[MAX_DEPTH + 1];
+    parentAtDepth[0] = 0;
+    for (int i = 1; i < nodeCount; i++) {
+        int depth = thread->nodes[i].depth;
+        childTotals[parentAtDepth[depth - 1]]++;
+        parentAtDepth[depth] = i;
+    }
+
+    // ȷнڵͰظӽڵ飬ʧʱȫͷţֶ״̬
+    CommentNode** rootChildren = NULL;
+    int rootCapacity = childTotals[0];
+    int created = 1;
+    int ok = 1;
+    if (rootCapacity > 0) {
+        rootChildren = (CommentNode**)malloc(rootCapacity * sizeof(CommentNode*));
+        ok = (rootChildren != NULL);
+    }
+    while (ok && created < nodeCount) {
+        FrozenComment* comment = &thread->nodes[created];
+        CommentNode* node = createCommentNode(comment->id,
+                                              thread->contents + comment->contentOffset,
+                                              thread->authors + comment->authorOffset);
+        if (node == NULL) break;
+        node->likeCount = comment->likeCount;
+        node->timestamp = comment->timestamp;
+        if (childTotals[created] > 0) {
+            node->children = (CommentNode**)malloc(childTotals[created] * sizeof(CommentNode*));
+            if (node->children == NULL) {
+                free(node);
+                break;
+            }
+            node->childCapacity = childTotals[created];
+        }
+        nodes[created++] = node;
+    }
+    free(childTotals);
+    if (!ok || created < nodeCount) {
+        printf("ڴʧܣ\n");
+        for (int i = 1; i < created; i++) {
+            free(nodes[i]->children);
+            free(nodes[i]);
+        }
+        free(rootChildren);
+        free(nodes);
+        return 0;
+    }
+
+    // ؽӹϵӽڵѾãattachReplyٷڴ
+    CommentNode* lastAtDepth[MAX_DEPTH + 1];
+    lastAtDepth[0] = root;
+    root->children = rootChildren;
+    root->childCapacity = rootCapacity;
+    root->frozen = NULL;
+    root->descendantCount = 0;  // attachReplyۼ
+    for (int i = 1; i < nodeCount; i++) {
+        int depth = thread->nodes[i].depth;
+        attachReply(lastAtDepth[depth - 1], nodes[i]);
+        lastAtDepth[depth] = nodes[i];
+        system->idIndex[nodes[i]->id] = nodes[i];
+    }
+
+    free(nodes);
+    freeFrozenThread(thread);
+    return 1;
+}
+
+// ֻȡϢҲ0
+int getCommentView(CommentSystem* system, int id, CommentView* view) {
+    if (id <= 0 || id >= system->idCapacity || system->idIndex[id] == NULL) {
+        return 0;
+    }
+
+    CommentNode* node = system->idIndex[id];
+    if (node->frozen != NULL) {
+        FrozenThread* thread = node->frozen;
+        int offset = findFrozenOffset(thread, id);
+        if (offset < 0) return 0;
+
+        FrozenComment* comment = &thread->nodes[offset];
+        view->id = comment->id;
+        view->author = thread->authors + comment->authorOffset;
+        view->content = thread->contents + comment->contentOffset;
+        view->likeCount = comment->likeCount;
+        view->depth = comment->depth;
+        view->replyCount = comment->subtreeSize - 1;
+    } else {
+        view->id = node->id;
+        view->author = node->author;
+        view->content = node->content;
+        view->likeCount = node->likeCount;
+        view->depth = node->depth;
+        view->replyCount = node->descendantCount;
+    }
+    return 1;
+}
 // ǰʾǰۣʾ
 void displayComment(CommentNode* node, int indent) {
     if (node == NULL) return;
 
+    // ¥ֱڽʾ
+    if (node->frozen != NULL) {
+        displayFrozenComment(node->frozen, 0, indent);
+        return;
+    }
+
     // ӡʾ㼶
     for (int i = 0; i < indent; i++) {
         printf("  ");  // ÿ2ո
@@ -180,6 +1336,22 @@ void displayComment(CommentNode* node, int indent) {
         displayComment(node->children[i], indent + 1);
     }
 }
+// ʾָIDۼظ¥ⶳҲ0
+int displayCommentById(CommentSystem* system, int id) {
+    if (id <= 0 || id >= system->idCapacity || system->idIndex[id] == NULL) {
+        return 0;
+    }
+
+    CommentNode* node = system->idIndex[id];
+    if (node->frozen != NULL) {
+        int offset = findFrozenOffset(node->frozen, id);
+        if (offset < 0) return 0;
+        displayFrozenComment(node->frozen, offset, 0);
+    } else {
+        displayComment(node, 0);
+    }
+    return 1;
+}
 // Ա
 /*int main() {
     CommentNode* root = createCommentNode(1, "", "ûA");
@@ -209,14 +1381,16 @@ void postOrderTraverse(CommentNode* node, void (*visit)(CommentNode*)) {
 }
 // ʾۼظ
 void displayAllComments(CommentSystem* system) {
-    if (system->rootCount == 0) {
+    if (getRootCommentCount(system) == 0) {
         printf("ۣ\n");
         return;
     }
 
     printf("\n========== б ==========\n");
+    int number = 0;
     for (int i = 0; i < system->rootCount; i++) {
-        printf("\n---  %d ---\n", i + 1);
+        if (system->rootComments[i] == NULL) continue;  // ɾĿλ
+        printf("\n---  %d ---\n", ++number);
         displayComment(system->rootComments[i], 0);
     }
     printf("\n==============================\n\n");
@@ -241,15 +1415,295 @@ CommentNode* findCommentById(CommentNode* root, int id) {
     return NULL;
 }
 
-// ϵͳв
-CommentNode* findCommentInSystem(CommentSystem* system, int id) {
-    for (int i = 0; i < system->rootCount; i++) {
-        CommentNode* found = findCommentById(system->rootComments[i], id);
-        if (found != NULL) {
-            return found;
+// ϵͳвۣͨIDO(1)
+// ظɾȽṹ޸ʹã¥ѶʱȽⶳֻжǷgetCommentViewaddLikes
+CommentNode* findCommentInSystem(CommentSystem* system, int id) {
+    METRIC_START(METRIC_FIND, startNanos);
+    CommentNode* node = NULL;
+    if (id > 0 && id < system->idCapacity) {
+        node = system->idIndex[id];
+        if (node != NULL && node->frozen != NULL) {
+            node = thawThread(system, node) ? system->idIndex[id] : NULL;
+        }
+    }
+    METRIC_STOP(METRIC_FIND, startNanos);
+    return node;
+}
+// ӢĴСджcontentǷphrase
+int containsIgnoreCase(const char* content, const char* phrase) {
+    int phraseLen = strlen(phrase);
+    for (const char* p = content; *p; p++) {
+        int i = 0;
+        while (i < phraseLen && p[i] &&
+               tolower((unsigned char)p[i]) == tolower((unsigned char)phrase[i])) {
+            i++;
+        }
+        if (i == phraseLen) return 1;
+    }
+    return 0;
+}
+
+// жaǷӦbǰ棨÷ָߵǰ÷ͬIDСǰ
+int hitRanksBefore(const SearchHit* a, const SearchHit* b) {
+    if (a->score != b->score) return a->score > b->score;
+    return a->id < b->id;
+}
+
+// 󶥶³ѶǵǰǰУ
+void siftDownHits(SearchHit* hits, int count, int i) {
+    while (1) {
+        int best = i;
+        int left = 2 * i + 1, right = 2 * i + 2;
+        if (left < count && hitRanksBefore(&hits[left], &hits[best])) best = left;
+        if (right < count && hitRanksBefore(&hits[right], &hits[best])) best = right;
+        if (best == i) return;
+
+        SearchHit temp = hits[i];
+        hits[i] = hits[best];
+        hits[best] = temp;
+        i = best;
+    }
+}
+
+// Ƚϵűȣ̵Ⱥϲ
+int comparePostingLength(const void* a, const void* b) {
+    const PostingList* x = *(PostingList* const*)a;
+    const PostingList* y = *(PostingList* const*)b;
+    return x->docFreq - y->docFreq;
+}
+
+// ȫոָĴҪͬʱ֣AND˫Ĳְƥ䣬BM25÷
+// дresultIdsscoresΪNULL
+int searchComments(CommentSystem* system, const char* query,
+                   int* resultIds, double* scores, int maxResults) {
+    SearchIndex* index = &system->searchIndex;
+
+    // 1. дʲȥ
+    char tokens[MAX_TOKENS_PER_TEXT][MAX_TOKEN_LEN];
+    int tokenCount = tokenizeText(query, tokens, MAX_TOKENS_PER_TEXT, 1);
+    if (tokenCount == 0) return 0;
+    qsort(tokens, tokenCount, MAX_TOKEN_LEN, compareTokens);
+
+    PostingList* lists[MAX_TOKENS_PER_TEXT];
+    int listCount = 0;
+    for (int i = 0; i < tokenCount; i++) {
+        if (i > 0 && strcmp(tokens[i], tokens[i - 1]) == 0) continue;
+        PostingList* list = findTerm(index, tokens[i]);
+        if (list == NULL || list->docFreq == 0) return 0;  // дʲڣANDΪ
+        lists[listCount++] = list;
+    }
+
+    // 2. ̵ĵűʼ󽻼ߺϲۼӵ÷
+    qsort(lists, listCount, sizeof(PostingList*), comparePostingLength);
+    double idf[MAX_TOKENS_PER_TEXT];
+    for (int k = 0; k < listCount; k++) {
+        idf[k] = bm25Idf(index, lists[k]->docFreq);
+    }
+
+    SearchHit* hits = (SearchHit*)malloc(lists[0]->docFreq * sizeof(SearchHit));
+    if (hits == NULL) {
+        printf("ڴʧܣ\n");
+        return 0;
+    }
+
+    int hitCount = 0;
+    PostingCursor cursor;
+    startPostingCursor(&cursor, lists[0]);
+    while (nextPosting(&cursor)) {
+        int length = index->docLength[cursor.docId];
+        if (length <= 0) continue;  // ɾ
+        hits[hitCount].id = cursor.docId;
+        hits[hitCount].score = bm25Score(index, idf[0], cursor.termFreq, length);
+        hitCount++;
+    }
+
+    for (int k = 1; k < listCount && hitCount > 0; k++) {
+        int kept = 0, i = 0;
+        startPostingCursor(&cursor, lists[k]);
+        while (i < hitCount && nextPosting(&cursor)) {
+            while (i < hitCount && hits[i].id < cursor.docId) i++;
+            if (i < hitCount && hits[i].id == cursor.docId) {
+                hits[kept] = hits[i];
+                hits[kept].score += bm25Score(index, idf[k], cursor.termFreq,
+                                              index->docLength[cursor.docId]);
+                kept++;
+                i++;
+            }
+        }
+        hitCount = kept;
+    }
+
+    // 3. ȡ˫Ķ
+    char phrases[MAX_QUERY_PHRASES][MAX_CONTENT_LEN];
+    int phraseCount = 0;
+    const char* p = query;
+    while (phraseCount < MAX_QUERY_PHRASES && (p = strchr(p, '"')) != NULL) {
+        const char* end = strchr(p + 1, '"');
+        if (end == NULL) break;
+
+        int phraseLen = (int)(end - p - 1);
+        if (phraseLen >= MAX_CONTENT_LEN) phraseLen = MAX_CONTENT_LEN - 1;
+        memcpy(phrases[phraseCount], p + 1, phraseLen);
+        phrases[phraseCount++][phraseLen] = '\0';
+        p = end + 1;
+    }
+
+    // 4. Ѻ󰴵÷ִӸߵȡֻȡʱԭȷϣչmaxResultsֹͣ
+    for (int i = hitCount / 2 - 1; i >= 0; i--) {
+        siftDownHits(hits, hitCount, i);
+    }
+
+    int count = 0;
+    while (hitCount > 0 && count < maxResults) {
+        SearchHit top = hits[0];
+        hits[0] = hits[--hitCount];
+        siftDownHits(hits, hitCount, 0);
+
+        CommentView view;
+        if (!getCommentView(system, top.id, &view)) continue;
+
+        int matched = 1;
+        for (int k = 0; k < phraseCount && matched; k++) {
+            matched = containsIgnoreCase(view.content, phrases[k]);
+        }
+        if (!matched) continue;
+
+        resultIds[count] = top.id;
+        if (scores != NULL) scores[count] = top.score;
+        count++;
+    }
+
+    free(hits);
+    return count;
+}
+// ʼҳÿҳһԷ䣬1..MAX_PAGE_SIZE
+int initPageBuffer(PageBuffer* buffer, int pageSize) {
+    if (pageSize < 1) pageSize = 1;
+    if (pageSize > MAX_PAGE_SIZE) pageSize = MAX_PAGE_SIZE;
+    size_t capacity = (size_t)pageSize * PAGE_ITEM_LEN + 1;
+    buffer->capacity = (int)capacity;
+    buffer->data = (char*)malloc(capacity);
+    if (buffer->data == NULL) {
+        printf("ڴʧܣ\n");
+        buffer->capacity = 0;
+        return 0;
+    }
+    buffer->size = 0;
+    buffer->data[0] = '\0';
+    return 1;
+}
+
+// ͷŷҳ
+void freePageBuffer(PageBuffer* buffer) {
+    free(buffer->data);
+    buffer->data = NULL;
+    buffer->size = 0;
+    buffer->capacity = 0;
+}
+
+// ҳ׷Ӹʽıʱضϣ
+void appendToPage(PageBuffer* buffer, const char* format, ...) {
+    int remaining = buffer->capacity - buffer->size;
+    if (remaining <= 1) return;
+
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(buffer->data + buffer->size, remaining, format, args);
+    va_end(args);
+
+    if (written < 0) return;
+    buffer->size += (written < remaining) ? written : remaining - 1;
+}
+
+// ڲλдstartʼҵһδɾ
+CommentNode* firstLiveSlot(CommentNode** slots, int count, int start) {
+    for (int i = start; i < count; i++) {
+        if (slots[i] != NULL) return slots[i];
+    }
+    return NULL;
+}
+
+// ǰһҪʾۣδ۵ʱȽۣһֵܣٲϻ
+CommentNode* nextVisibleComment(CommentSystem* system, CommentNode* node, int collapseDepth) {
+    if (node->depth < collapseDepth) {
+        CommentNode* child = firstLiveSlot(node->children, node->childCount, 0);
+        if (child != NULL) return child;
+    }
+
+    while (node != NULL) {
+        CommentNode* sibling = (node->parent == NULL) ?
+            firstLiveSlot(system->rootComments, system->rootCount, node->slotIndex + 1) :
+            firstLiveSlot(node->parent->children, node->parent->childCount, node->slotIndex + 1);
+        if (sibling != NULL) return sibling;
+        node = node->parent;
+    }
+    return NULL;
+}
+
+// Ⱦҳеһۣ۵ûĻظʾ
+void appendCommentItem(PageBuffer* buffer, int depth, const char* author, const char* content,
+                       int likeCount, int id, int replyCount, int collapseDepth) {
+    if (depth == 0) {
+        appendToPage(buffer, "\n");  // ֮һ
+    }
+    appendToPage(buffer, "%*s[%s] %s (: %d, ID: %d)\n",
+                 depth * 2, "", author, content, likeCount, id);
+
+    if (depth >= collapseDepth && replyCount > 0) {
+        appendToPage(buffer, "%*s...  %d ظ\n", (depth + 1) * 2, "", replyCount);
+    }
+}
+
+// ҳȾcursorIdӦۿʼ0ʾͷʼǰȾpageSizebuffer
+// ȴﵽcollapseDepth۲չֻʾ"Nظ"ֻÿҳй
+// һҳα꣨0ʾѾףαӦѱɾʱ-1
+int renderCommentPage(CommentSystem* system, int cursorId, int pageSize,
+                      int collapseDepth, PageBuffer* buffer) {
+    buffer->size = 0;
+    buffer->data[0] = '\0';
+
+    // ǰλãnodeǻеۣnodeǶ¥ۣoffset¥ڵǰ±
+    CommentNode* node;
+    int offset = 0;
+    if (cursorId == 0) {
+        node = firstLiveSlot(system->rootComments, system->rootCount, 0);
+    } else {
+        if (cursorId >= system->idCapacity || system->idIndex[cursorId] == NULL) return -1;
+        node = system->idIndex[cursorId];
+        if (node->frozen != NULL) {
+            offset = findFrozenOffset(node->frozen, cursorId);
+            if (offset < 0) return -1;
         }
     }
-    return NULL;
+
+    for (int rendered = 0; node != NULL && rendered < pageSize; rendered++) {
+        if (buffer->capacity - buffer->size < PAGE_ITEM_LEN) break;  // һ
+
+        if (node->frozen != NULL) {
+            // ¥ǰһoffset+1۵ֻsubtreeSize
+            FrozenThread* thread = node->frozen;
+            FrozenComment* comment = &thread->nodes[offset];
+            appendCommentItem(buffer, comment->depth,
+                              thread->authors + comment->authorOffset,
+                              thread->contents + comment->contentOffset,
+                              comment->likeCount, comment->id,
+                              comment->subtreeSize - 1, collapseDepth);
+
+            offset += (comment->depth < collapseDepth) ? 1 : comment->subtreeSize;
+            if (offset < thread->nodeCount) continue;
+
+            offset = 0;
+            node = firstLiveSlot(system->rootComments, system->rootCount, node->slotIndex + 1);
+        } else {
+            appendCommentItem(buffer, node->depth, node->author, node->content,
+                              node->likeCount, node->id,
+                              node->descendantCount, collapseDepth);
+            node = nextVisibleComment(system, node, collapseDepth);
+        }
+    }
+
+    if (node == NULL) return 0;
+    return (node->frozen != NULL) ? node->frozen->nodes[offset].id : node->id;
 }
 // ĳߵ
 void findCommentsByAuthor(CommentNode* root, char* author,
@@ -271,91 +1725,257 @@ void findCommentsByAuthor(CommentNode* root, char* author,
 void removeFromParent(CommentNode* parent, CommentNode* child) {
     if (parent == NULL || child == NULL) return;
 
-    // ӽڵеλ
-    int index = -1;
-    for (int i = 0; i < parent->childCount; i++) {
-        if (parent->children[i] == child) {
-            index = i;
-            break;
-        }
-    }
-
-    if (index == -1) {
+    // ͨslotIndexֱӶλӽڵ
+    int index = child->slotIndex;
+    if (index < 0 || index >= parent->childCount || parent->children[index] != child) {
         printf("δҵӽڵ㣡\n");
         return;
     }
 
-    // Ԫǰ
-    for (int i = index; i < parent->childCount - 1; i++) {
-        parent->children[i] = parent->children[i + 1];
+    // Ĺǰƣظʾ˳򲻱
+    tombstoneSlot(parent->children, &parent->childCount,
+                  &parent->deletedChildCount, index);
+
+    for (CommentNode* ancestor = parent; ancestor != NULL; ancestor = ancestor->parent) {
+        ancestor->descendantCount -= 1 + child->descendantCount;
+    }
+}
+// ͷۼ۵ڴ棨븸ڵĹϵ
+void freeCommentTree(CommentNode* node) {
+    if (node == NULL) return;
+
+    if (node->frozen != NULL) {
+        freeFrozenThread(node->frozen);
+    }
+
+    for (int i = 0; i < node->childCount; i++) {
+        freeCommentTree(node->children[i]);
     }
 
-    parent->childCount--;
+    if (node->children != NULL) {
+        free(node->children);
+    }
+    free(node);
 }
-// ɾۼۣɾ
-void deleteComment(CommentNode* node) {
+// ͳıֽ
+void measureSubtreeText(CommentNode* node, int* contentBytes, int* authorBytes) {
     if (node == NULL) return;
 
-    // ɾۣ
-    for (int i = node->childCount - 1; i >= 0; i--) {
-        deleteComment(node->children[i]);
+    *contentBytes += strlen(node->content) + 1;
+    *authorBytes += strlen(node->author) + 1;
+    for (int i = 0; i < node->childCount; i++) {
+        measureSubtreeText(node->children[i], contentBytes, authorBytes);
+    }
+}
+
+// ǰд붳¥ڵ
+int fillFrozenThread(FrozenThread* thread, CommentNode* node, int* authorSlots, unsigned int slotMask) {
+    int offset = thread->nodeCount++;
+    FrozenComment* comment = &thread->nodes[offset];
+    comment->id = node->id;
+    comment->likeCount = node->likeCount;
+    comment->timestamp = node->timestamp;
+    comment->depth = node->depth;
+
+    int length = strlen(node->content) + 1;
+    comment->contentOffset = thread->contentsSize;
+    memcpy(thread->contents + thread->contentsSize, node->content, length);
+    thread->contentsSize += length;
+
+    // ȥأauthorSlotsʱϣ"ƫ+1"0ʾղ
+    unsigned int slot = hashToken(node->author) & slotMask;
+    while (authorSlots[slot] != 0 &&
+           strcmp(thread->authors + authorSlots[slot] - 1, node->author) != 0) {
+        slot = (slot + 1) & slotMask;
+    }
+    if (authorSlots[slot] == 0) {
+        length = strlen(node->author) + 1;
+        authorSlots[slot] = thread->authorsSize + 1;
+        memcpy(thread->authors + thread->authorsSize, node->author, length);
+        thread->authorsSize += length;
+    }
+    comment->authorOffset = authorSlots[slot] - 1;
+
+    int size = 1;
+    for (int i = 0; i < node->childCount; i++) {
+        if (node->children[i] != NULL) {
+            size += fillFrozenThread(thread, node->children[i], authorSlots, slotMask);
+        }
     }
+    thread->nodes[offset].subtreeSize = size;
+    return size;
+}
+
+// IDȽ϶¥qsort
+int compareFrozenIds(const void* a, const void* b) {
+    return ((const FrozenIdEntry*)a)->id - ((const FrozenIdEntry*)b)->id;
+}
+
+// ɾۼۣɾ
+void deleteComment(CommentNode* node) {
+    if (node == NULL) return;
 
-    // ӸڵƳ
+    // ӸڵƳһͷţƳ
     if (node->parent != NULL) {
         removeFromParent(node->parent, node);
     }
 
-    // ͷӽڵڴ
-    if (node->children != NULL) {
-        free(node->children);
+    // ͷڴ棨
+    freeCommentTree(node);
+}
+// ¥ۼлظתɽյǰ飬ͷԭĻظڵ
+// ۽ڵ㱣rootCommentsΪ¥ľظIDָ
+int freezeThread(CommentSystem* system, CommentNode* root) {
+    if (root->parent != NULL || root->frozen != NULL) return 0;
+
+    int nodeCount = 1 + root->descendantCount;
+    int contentBytes = 0, authorBytes = 0;
+    measureSubtreeText(root, &contentBytes, &authorBytes);
+
+    unsigned int slotCount = 16;
+    while (slotCount < (unsigned int)nodeCount * 2) slotCount *= 2;
+
+    FrozenThread* thread = (FrozenThread*)calloc(1, sizeof(FrozenThread));
+    int* authorSlots = (int*)calloc(slotCount, sizeof(int));
+    if (thread != NULL) {
+        thread->nodes = (FrozenComment*)malloc(nodeCount * sizeof(FrozenComment));
+        thread->idOrder = (FrozenIdEntry*)malloc(nodeCount * sizeof(FrozenIdEntry));
+        thread->authors = (char*)malloc(authorBytes);
+        thread->contents = (char*)malloc(contentBytes);
+    }
+    if (thread == NULL || authorSlots == NULL || thread->nodes == NULL ||
+        thread->idOrder == NULL || thread->authors == NULL || thread->contents == NULL) {
+        printf("ڴʧܣ\n");
+        freeFrozenThread(thread);
+        free(authorSlots);
+        return 0;
     }
 
-    // ͷŽڵ㱾
-    free(node);
+    fillFrozenThread(thread, root, authorSlots, slotCount - 1);
+    free(authorSlots);
+
+    // ȥغͨԶСԤһ
+    char* shrunk = (char*)realloc(thread->authors, thread->authorsSize);
+    if (shrunk != NULL) thread->authors = shrunk;
+
+    for (int i = 0; i < nodeCount; i++) {
+        thread->idOrder[i].id = thread->nodes[i].id;
+        thread->idOrder[i].offset = i;
+    }
+    qsort(thread->idOrder, nodeCount, sizeof(FrozenIdEntry), compareFrozenIds);
+
+    // ͷŻظڵ㣬IDΪָ
+    for (int i = 1; i < nodeCount; i++) {
+        system->idIndex[thread->nodes[i].id] = root;
+    }
+    for (int i = 0; i < root->childCount; i++) {
+        freeCommentTree(root->children[i]);
+    }
+    free(root->children);
+    root->children = NULL;
+    root->childCount = 0;
+    root->childCapacity = 0;
+    root->deletedChildCount = 0;
+    root->frozen = thread;
+    return 1;
+}
+
+// һ۵ʱ
+time_t getLatestActivity(CommentNode* node) {
+    time_t latest = node->timestamp;
+    for (int i = 0; i < node->childCount; i++) {
+        if (node->children[i] == NULL) continue;
+        time_t childLatest = getLatestActivity(node->children[i]);
+        if (childLatest > latest) latest = childLatest;
+    }
+    return latest;
+}
+
+// ᳬidleSecondsû»ظ¥ض¥
+int freezeInactiveThreads(CommentSystem* system, int idleSeconds) {
+    time_t now = time(NULL);
+    int frozenCount = 0;
+
+    for (int i = 0; i < system->rootCount; i++) {
+        CommentNode* root = system->rootComments[i];
+        if (root == NULL || root->frozen != NULL) continue;
+        if (now - getLatestActivity(root) >= idleSeconds && freezeThread(system, root)) {
+            frozenCount++;
+        }
+    }
+    return frozenCount;
+}
+
+// ռõڴ棨ڵӽڵ飩
+long long estimateLiveBytes(CommentNode* node) {
+    if (node == NULL) return 0;
+
+    long long bytes = sizeof(CommentNode) + strlen(node->content) + strlen(node->author) + 2 +
+                      node->childCapacity * sizeof(CommentNode*);
+    for (int i = 0; i < node->childCount; i++) {
+        bytes += estimateLiveBytes(node->children[i]);
+    }
+    return bytes;
+}
+
+// 㶳¥ռõڴ棨Ϊ۽ڵ㣩
+long long estimateFrozenBytes(CommentNode* root) {
+    FrozenThread* thread = root->frozen;
+    return sizeof(CommentNode) + strlen(root->content) + strlen(root->author) + 2 + sizeof(FrozenThread) +
+           (long long)thread->nodeCount * (sizeof(FrozenComment) + sizeof(FrozenIdEntry)) +
+           thread->authorsSize + thread->contentsSize;
+}
+
+// ϵͳƳͷۼлظʾ
+void removeCommentFromSystem(CommentSystem* system, CommentNode* target) {
+    // IDע
+    unregisterSubtree(system, target);
+
+    // ֱۣӰslotIndexƳ
+    if (target->parent == NULL) {
+        tombstoneSlot(system->rootComments, &system->rootCount,
+                      &system->rootDeletedCount, target->slotIndex);
+    }
+
+    // ɾۼ
+    deleteComment(target);
 }
 // ϵͳɾָID
 int deleteCommentFromSystem(CommentSystem* system, int id) {
+    METRIC_START(METRIC_DELETE, startNanos);
     // 
     CommentNode* target = findCommentInSystem(system, id);
     if (target == NULL) {
+        METRIC_STOP(METRIC_DELETE, startNanos);
         printf("δҵIDΪ %d ۣ\n", id);
         return 0;
     }
 
-    // ۣϵͳƳ
-    if (target->parent == NULL) {
-        // вҲƳ
-        for (int i = 0; i < system->rootCount; i++) {
-            if (system->rootComments[i] == target) {
-                // Ԫǰ
-                for (int j = i; j < system->rootCount - 1; j++) {
-                    system->rootComments[j] = system->rootComments[j + 1];
-                }
-                system->rootCount--;
-                break;
-            }
-        }
-    }
-
-    // ɾۼ
-    deleteComment(target);
+    removeCommentFromSystem(system, target);
+    METRIC_STOP(METRIC_DELETE, startNanos);
 
     printf(" %d лظɾ\n", id);
     return 1;
 }
-// ͳĳۼ۵
+// ͷϵͳ
+void destroyCommentSystem(CommentSystem* system) {
+    for (int i = 0; i < system->rootCount; i++) {
+        freeCommentTree(system->rootComments[i]);
+    }
+    if (system->rootComments != NULL) {
+        free(system->rootComments);
+    }
+    if (system->idIndex != NULL) {
+        free(system->idIndex);
+    }
+    freeSearchIndex(&system->searchIndex);
+    initCommentSystem(system);
+}
+// ͳĳۼ۵ʹûĻظ
 int countAllComments(CommentNode* root) {
     if (root == NULL) return 0;
 
-    int count = 1;  // ǰڵ
-
-    // ݹͳӽڵ
-    for (int i = 0; i < root->childCount; i++) {
-        count += countAllComments(root->children[i]);
-    }
-
-    return count;
+    return 1 + root->descendantCount;  // ǰڵ + лظ
 }
 
 // ͳϵͳе
@@ -369,6 +1989,17 @@ int countTotalComments(CommentSystem* system) {
 // 
 int getTreeDepth(CommentNode* root) {
     if (root == NULL) return 0;
+
+    if (root->frozen != NULL) {
+        int maxDepth = 0;
+        for (int i = 0; i < root->frozen->nodeCount; i++) {
+            if (root->frozen->nodes[i].depth > maxDepth) {
+                maxDepth = root->frozen->nodes[i].depth;
+            }
+        }
+        return maxDepth + 1;
+    }
+
     if (root->childCount == 0) return 1;
 
     int maxChildDepth = 0;
@@ -383,14 +2014,142 @@ int getTreeDepth(CommentNode* root) {
 }
 // ۵
 void likeComment(CommentNode* comment) {
+    METRIC_START(METRIC_LIKE, startNanos);
     if (comment == NULL) {
+        METRIC_STOP(METRIC_LIKE, startNanos);
         printf("۲ڣ\n");
         return;
     }
 
     comment->likeCount++;
+    METRIC_STOP(METRIC_LIKE, startNanos);
     printf(" %d ޳ɹǰ%d\n", comment->id, comment->likeCount);
 }
+
+// ۼlikesޣ¥ֱӸĽ飬ⶳ۲ڷ0
+int addLikes(CommentSystem* system, int id, int likes) {
+    if (id <= 0 || id >= system->idCapacity || system->idIndex[id] == NULL) {
+        return 0;
+    }
+
+    CommentNode* node = system->idIndex[id];
+    if (node->frozen != NULL) {
+        int offset = findFrozenOffset(node->frozen, id);
+        if (offset < 0) return 0;
+        node->frozen->nodes[offset].likeCount += likes;
+    } else {
+        node->likeCount += likes;
+    }
+    return 1;
+}
+
+// ID۵ޣͨID¥ⶳҲ0
+int likeCommentById(CommentSystem* system, int id) {
+    METRIC_START(METRIC_LIKE, startNanos);
+    int found = addLikes(system, id, 1);
+    METRIC_STOP(METRIC_LIKE, startNanos);
+
+    CommentView view;
+    if (!found || !getCommentView(system, id, &view)) {
+        printf("δҵIDΪ %d ۣ\n", id);
+        return 0;
+    }
+    printf(" %d ޳ɹǰ%d\n", id, view.likeCount);
+    return 1;
+}
+
+// ʼ޻
+int initLikeBuffer(LikeBuffer* buffer) {
+    buffer->ids = (int*)calloc(LIKE_BUFFER_CAPACITY, sizeof(int));
+    buffer->counts = (int*)malloc(LIKE_BUFFER_CAPACITY * sizeof(int));
+    if (buffer->ids == NULL || buffer->counts == NULL) {
+        printf("ڴʧܣ\n");
+        free(buffer->ids);
+        free(buffer->counts);
+        buffer->ids = NULL;
+        buffer->counts = NULL;
+        return 0;
+    }
+    buffer->capacity = LIKE_BUFFER_CAPACITY;
+    buffer->distinct = 0;
+    buffer->pending = 0;
+    return 1;
+}
+
+// ѻµĵдۣÿһΣдĵ
+int flushLikeBuffer(CommentSystem* system, LikeBuffer* buffer) {
+    if (buffer->distinct == 0) return 0;
+
+    METRIC_START(METRIC_LIKE_BATCH, startNanos);
+    int applied = 0;
+    for (int i = 0; i < buffer->capacity; i++) {
+        if (buffer->ids[i] == 0) continue;
+        if (addLikes(system, buffer->ids[i], buffer->counts[i])) {
+            applied += buffer->counts[i];
+        }
+        buffer->ids[i] = 0;
+    }
+    buffer->distinct = 0;
+    buffer->pending = 0;
+    METRIC_STOP(METRIC_LIKE_BATCH, startNanos);
+    return applied;
+}
+
+// ͷŵ޻д뻹ûϲĵޣ
+void freeLikeBuffer(CommentSystem* system, LikeBuffer* buffer) {
+    flushLikeBuffer(system, buffer);
+    free(buffer->ids);
+    free(buffer->counts);
+    buffer->ids = NULL;
+    buffer->counts = NULL;
+}
+
+// ڻиۼһޣдۣвͬﵽ3/4ʱ1ʾúϲд
+int stageLike(LikeBuffer* buffer, int id) {
+    if (id <= 0) return 0;
+
+    unsigned int mask = buffer->capacity - 1;
+    unsigned int slot = ((unsigned int)id * 2654435761u) & mask;
+    while (buffer->ids[slot] != 0 && buffer->ids[slot] != id) {
+        slot = (slot + 1) & mask;
+    }
+    if (buffer->ids[slot] == 0) {
+        buffer->ids[slot] = id;
+        buffer->counts[slot] = 0;
+        buffer->distinct++;
+    }
+    buffer->counts[slot]++;
+    buffer->pending++;
+    return buffer->distinct * 4 >= buffer->capacity * 3;
+}
+
+// һۣȼڻʱϲд룩
+// ûжʱʱ޻һֱڻȡ֮ǰ˳ǰҪflushLikeBuffer
+// ˵ÿε޺ҪʾֱlikeCommentById
+void bufferLike(CommentSystem* system, LikeBuffer* buffer, int id) {
+    if (stageLike(buffer, id)) {
+        flushLikeBuffer(system, buffer);
+    }
+}
+
+// ޣһСϣ޻ͬIDϲÿÿֻдһΣ޸ids
+// ϣֻLIKE_BUFFER_CAPACITYλڻسɹдĵڵ۱ԣ
+int likeCommentsBatch(CommentSystem* system, const int* ids, int count) {
+    LikeBuffer buffer;
+    if (!initLikeBuffer(&buffer)) return 0;
+
+    int applied = 0;
+    for (int i = 0; i < count; i++) {
+        if (stageLike(&buffer, ids[i])) {
+            applied += flushLikeBuffer(system, &buffer);
+        }
+    }
+    applied += flushLikeBuffer(system, &buffer);
+
+    free(buffer.ids);
+    free(buffer.counts);
+    return applied;
+}
 // Ϣ
 void inputCommentInfo(char* content, char* author) {
     printf("ݣ");
@@ -401,6 +2160,323 @@ void inputCommentInfo(char* content, char* author) {
     fgets(author, MAX_AUTHOR_LEN, stdin);
     author[strcspn(author, "\n")] = 0;  // Ƴз
 }
+// ɣxorshift64*rand()Χҿɸ֣
+unsigned long long nextRandom(unsigned long long* state) {
+    unsigned long long x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 2685821657736338717ULL;
+}
+// 룺ÿһ¼"ID\tID\t\t\tʱ"IDΪ0ʾ
+// ۱ڻظ֮ǰһ齨ɭ֣̲سɹ
+// ڴ棺ϳݣƽıԼ20ֽڣÿͬIDȫԼռ280ֽڣ10^7Լ2.8GB
+int bulkLoadComments(CommentSystem* system, FILE* file, int* skipped) {
+    char line[MAX_CONTENT_LEN + MAX_AUTHOR_LEN + 64];
+    int loaded = 0;
+    *skipped = 0;
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        int len = strcspn(line, "\r\n");
+        if (line[len] == '\0' && !feof(file)) {
+            // ̫ʣಿ
+            int c;
+            while ((c = fgetc(file)) != '\n' && c != EOF) {}
+        }
+        line[len] = '\0';
+        if (line[0] == '\0' || line[0] == '#') continue;  // кע
+
+        // Ʊֶ
+        char* fields[5] = {NULL};
+        int fieldCount = 0;
+        char* p = line;
+        while (fieldCount < 5) {
+            fields[fieldCount++] = p;
+            p = strchr(p, '\t');
+            if (p == NULL) break;
+            *p++ = '\0';
+        }
+        if (fieldCount < 4) {
+            (*skipped)++;
+            continue;
+        }
+
+        int id = atoi(fields[0]);
+        int parentId = atoi(fields[1]);
+        if (id <= 0 || (id < system->idCapacity && system->idIndex[id] != NULL)) {
+            (*skipped)++;  // ЧظID
+            continue;
+        }
+
+        // ߺݽض
+        if (strlen(fields[2]) >= MAX_AUTHOR_LEN) fields[2][MAX_AUTHOR_LEN - 1] = '\0';
+        if (strlen(fields[3]) >= MAX_CONTENT_LEN) fields[3][MAX_CONTENT_LEN - 1] = '\0';
+
+        CommentNode* node = createCommentNode(id, fields[3], fields[2]);
+        if (node == NULL) break;
+        if (fieldCount >= 5) {
+            node->timestamp = (time_t)atoll(fields[4]);
+        }
+
+        int ok;
+        if (parentId == 0) {
+            ok = attachRootComment(system, node);
+        } else {
+            CommentNode* parent = findCommentInSystem(system, parentId);
+            ok = (parent != NULL) && registerComment(system, node);
+            if (ok && attachReply(parent, node) <= 0) {
+                unregisterSubtree(system, node);
+                ok = 0;
+            }
+        }
+
+        if (!ok) {
+            free(node);
+            (*skipped)++;
+            continue;
+        }
+
+        if (id >= system->nextId) {
+            system->nextId = id + 1;
+        }
+        loaded++;
+    }
+
+    return loaded;
+}
+// ɷֲĺϳݣÿһʿ¥һۻظ
+// ൱ڰ¥С¥¥ԽԽȣ¥Сɷֲ
+int generateSyntheticComments(FILE* file, int count, unsigned long long seed) {
+    static const char* words[] = {
+        "ÿ", "֧", "", "̫ʵ", "ͬ", "ͬ", "ǰ", "ɳ",
+        "ѧ", "л", "", "", "Ӱ", "ݽṹ", "㷨", "",
+        "hello", "great", "nice", "lol", "test", "video", "music", "wow"
+    };
+    int wordCount = sizeof(words) / sizeof(words[0]);
+
+    int* parentOf = (int*)malloc((count + 1) * sizeof(int));
+    unsigned char* depthOf = (unsigned char*)malloc(count + 1);
+    if (parentOf == NULL || depthOf == NULL) {
+        printf("ڴʧܣ\n");
+        free(parentOf);
+        free(depthOf);
+        return 0;
+    }
+
+    unsigned long long state = seed ? seed : 88172645463325252ULL;
+    time_t baseTime = time(NULL) - count;
+    char content[MAX_CONTENT_LEN];
+
+    for (int id = 1; id <= count; id++) {
+        int parentId = 0;
+        if (id > 1 && nextRandom(&state) % 100 >= SYNTHETIC_NEW_THREAD_PERCENT) {
+            parentId = 1 + (int)(nextRandom(&state) % (id - 1));
+            if (depthOf[parentId] >= MAX_DEPTH) {
+                parentId = parentOf[parentId];  // ʱظһ
+            }
+        }
+        parentOf[id] = parentId;
+        depthOf[id] = (parentId == 0) ? 0 : depthOf[parentId] + 1;
+
+        // ҲȡβֲԾû󲿷
+        int bound = 1 + (int)(nextRandom(&state) % SYNTHETIC_AUTHORS);
+        int author = (int)(nextRandom(&state) % bound);
+
+        int length = 0;
+        int wordCountInContent = 2 + (int)(nextRandom(&state) % 8);
+        for (int w = 0; w < wordCountInContent; w++) {
+            length += snprintf(content + length, sizeof(content) - length, "%s%s",
+                               w > 0 ? " " : "", words[nextRandom(&state) % wordCount]);
+        }
+
+        fprintf(file, "%d\t%d\tû%d\t%s\t%lld\n",
+                id, parentId, author, content, (long long)(baseTime + id));
+    }
+
+    free(parentOf);
+    free(depthOf);
+    return count;
+}
+// ܲԣѵִиʱ
+void runCommentBenchmark(CommentSystem* system, int operations) {
+    unsigned long long state = 2463534242ULL;
+    int maxId = system->nextId - 1;
+    if (maxId <= 0) {
+        printf("ۣ\n");
+        return;
+    }
+
+    printf("\n========== ܲ ==========\n");
+
+    clock_t start = clock();
+    int found = 0;
+    for (int i = 0; i < operations; i++) {
+        int id = 1 + (int)(nextRandom(&state) % maxId);
+        if (findCommentInSystem(system, id) != NULL) found++;
+    }
+    printf("ID %d Σ%.3f 루 %d\n",
+           operations, (double)(clock() - start) / CLOCKS_PER_SEC, found);
+
+    start = clock();
+    int total = countTotalComments(system);
+    printf("ͳ %d%.3f \n", total, (double)(clock() - start) / CLOCKS_PER_SEC);
+
+    start = clock();
+    int hits[MAX_SEARCH_RESULTS];
+    int searches = (operations < 100000) ? operations / 100 + 1 : 1000;
+    for (int i = 0; i < searches; i++) {
+        searchComments(system, (i % 2) ? "ݽṹ 㷨" : "\"л\"",
+                       hits, NULL, MAX_SEARCH_RESULTS);
+    }
+    printf("ȫ %d Σ%.3f \n", searches, (double)(clock() - start) / CLOCKS_PER_SEC);
+
+    // ޣģȵۣһĵ޼ǰ100
+    int likeCount = operations * 10;
+    int* likeIds = (int*)malloc(likeCount * sizeof(int));
+    LikeBuffer likeBuffer;
+    if (likeIds != NULL && initLikeBuffer(&likeBuffer)) {
+        for (int i = 0; i < likeCount; i++) {
+            int range = (nextRandom(&state) % 2) ? maxId : ((maxId < 100) ? maxId : 100);
+            likeIds[i] = 1 + (int)(nextRandom(&state) % range);
+        }
+
+        start = clock();
+        for (int i = 0; i < likeCount; i++) {
+            addLikes(system, likeIds[i], 1);
+        }
+        printf(" %d Σ%.3f \n", likeCount, (double)(clock() - start) / CLOCKS_PER_SEC);
+
+        start = clock();
+        for (int i = 0; i < likeCount; i++) {
+            bufferLike(system, &likeBuffer, likeIds[i]);
+        }
+        flushLikeBuffer(system, &likeBuffer);
+        printf("ϲ %d Σ%.3f \n", likeCount, (double)(clock() - start) / CLOCKS_PER_SEC);
+
+        start = clock();
+        int applied = likeCommentsBatch(system, likeIds, likeCount);
+        printf(" %d Σд %d ޣ%.3f \n",
+               likeCount, applied, (double)(clock() - start) / CLOCKS_PER_SEC);
+
+        freeLikeBuffer(system, &likeBuffer);
+    }
+    free(likeIds);
+
+    // ǰԱȣ߱¥ĺʱڴռ
+    const char* author = "û1";
+    CommentNode** authorResults = (CommentNode**)malloc(total * sizeof(CommentNode*));
+    int* authorOffsets = (int*)malloc(total * sizeof(int));
+    if (authorResults != NULL && authorOffsets != NULL) {
+        long long liveBytes = 0;
+        int matched = 0;
+        start = clock();
+        for (int i = 0; i < system->rootCount; i++) {
+            findCommentsByAuthor(system->rootComments[i], (char*)author,
+                                 authorResults, &matched, total);
+        }
+        printf("߲ң%.3f 루%d \n",
+               (double)(clock() - start) / CLOCKS_PER_SEC, matched);
+        for (int i = 0; i < system->rootCount; i++) {
+            liveBytes += estimateLiveBytes(system->rootComments[i]);
+        }
+
+        start = clock();
+        int frozenCount = freezeInactiveThreads(system, 0);
+        printf(" %d ¥%.3f \n",
+               frozenCount, (double)(clock() - start) / CLOCKS_PER_SEC);
+
+        long long frozenBytes = 0;
+        matched = 0;
+        start = clock();
+        // ڴ治ʱ¥ûжᣬ
+        for (int i = 0; i < system->rootCount; i++) {
+            if (system->rootComments[i] == NULL || system->rootComments[i]->frozen == NULL) continue;
+            int count = 0;
+            findFrozenCommentsByAuthor(system->rootComments[i]->frozen, author,
+                                       authorOffsets, &count, total);
+            matched += count;
+        }
+        printf("¥߲ң%.3f 루%d \n",
+               (double)(clock() - start) / CLOCKS_PER_SEC, matched);
+        for (int i = 0; i < system->rootCount; i++) {
+            CommentNode* root = system->rootComments[i];
+            if (root == NULL) continue;
+            frozenBytes += (root->frozen != NULL) ? estimateFrozenBytes(root) : estimateLiveBytes(root);
+        }
+        printf("ڴռãԼ %.1f MBԼ %.1f MB\n",
+               liveBytes / 1048576.0, frozenBytes / 1048576.0);
+    }
+    free(authorResults);
+    free(authorOffsets);
+
+    start = clock();
+    int deleted = 0;
+    for (int i = 0; i < operations; i++) {
+        int id = 1 + (int)(nextRandom(&state) % maxId);
+        CommentNode* target = findCommentInSystem(system, id);
+        if (target == NULL) continue;
+        removeCommentFromSystem(system, target);
+        deleted++;
+    }
+    printf("ɾ %d Σ%.3f 루ʵɾ %d\n",
+           operations, (double)(clock() - start) / CLOCKS_PER_SEC, deleted);
+    printf("==============================\n\n");
+}
+// ģʽ-1ʾ뽻˵Ϊ˳
+int runCommandLine(CommentSystem* system, int argc, char* argv[]) {
+    if (argc < 2) return -1;
+
+    if (strcmp(argv[1], "--generate") == 0 && argc >= 4) {
+        FILE* file = fopen(argv[3], "w");
+        if (file == NULL) {
+            printf("޷ļ %s\n", argv[3]);
+            return 1;
+        }
+        unsigned long long seed = (argc >= 5) ? strtoull(argv[4], NULL, 10) : 0;
+        int count = generateSyntheticComments(file, atoi(argv[2]), seed);
+        fclose(file);
+        printf(" %d ۵ %s\n", count, argv[3]);
+        return 0;
+    }
+
+    if ((strcmp(argv[1], "--import") == 0 || strcmp(argv[1], "--bench") == 0) && argc >= 3) {
+        FILE* file = fopen(argv[2], "r");
+        if (file == NULL) {
+            printf("޷ļ %s\n", argv[2]);
+            return 1;
+        }
+        int skipped;
+        clock_t start = clock();
+        int loaded = bulkLoadComments(system, file, &skipped);
+        fclose(file);
+        printf(" %d ۣ %d ʱ %.3f \n",
+               loaded, skipped, (double)(clock() - start) / CLOCKS_PER_SEC);
+
+        if (strcmp(argv[1], "--bench") == 0) {
+            runCommentBenchmark(system, (argc >= 4) ? atoi(argv[3]) : 100000);
+            // 5ָͳļĻ
+            FILE* out = (argc >= 5) ? fopen(argv[4], "w") : stdout;
+            if (out == NULL) {
+                printf("޷ļ %s\n", argv[4]);
+            } else {
+                dumpMetrics(out);
+                if (out != stdout) fclose(out);
+            }
+            destroyCommentSystem(system);
+            resetMetrics();
+            return 0;
+        }
+        return -1;
+    }
+
+    printf("÷\n");
+    printf("  %s                          ģʽ\n", argv[0]);
+    printf("  %s --import <ļ>          ۺ뽻ģʽ\n", argv[0]);
+    printf("  %s --generate <> <ļ> []  ɺϳ\n", argv[0]);
+    printf("  %s --bench <ļ> [] [ͳļ]  벢ܲ\n", argv[0]);
+    return 1;
+}
 // ˵
 void showMainMenu() {
     printf("\n========== ϵͳ ==========\n");
@@ -411,6 +2487,8 @@ void showMainMenu() {
     printf("5. ɾ\n");
     printf("6. \n");
     printf("7. ͳϢ\n");
+    printf("8. ҳ\n");
+    printf("9. ᲻Ծ¥\n");
     printf("0. ˳\n");
     printf("================================\n");
     printf("ѡ");
@@ -420,15 +2498,22 @@ void showSearchMenu() {
     printf("\n==========  ==========\n");
     printf("1. ID\n");
     printf("2. ߲\n");
+    printf("3. ȫ\n");
     printf("0. ˵\n");
     printf("================================\n");
     printf("ѡ");
 }
-int main() {
+int main(int argc, char* argv[]) {
     // 1. 
     CommentSystem system;
     initCommentSystem(&system);
 
+    // в롢ݻܲ
+    int exitCode = runCommandLine(&system, argc, argv);
+    if (exitCode >= 0) {
+        return exitCode;
+    }
+
     int choice, subChoice;
     int commentId, parentId;
     char content[MAX_CONTENT_LEN];
@@ -449,8 +2534,8 @@ int main() {
                     CommentNode* newComment = createCommentNode(
                         system.nextId++, content, author
                     );
-                    if (newComment != NULL) {
-                        addRootComment(&system, newComment);
+                    if (newComment != NULL && !addRootComment(&system, newComment)) {
+                        free(newComment);
                     }
                 }
                 break;
@@ -471,8 +2556,8 @@ int main() {
                     CommentNode* newReply = createCommentNode(
                         system.nextId++, content, author
                     );
-                    if (newReply != NULL) {
-                        addReply(parent, newReply);
+                    if (newReply != NULL && !addReplyToSystem(&system, parent, newReply)) {
+                        free(newReply);
                     }
                 }
                 break;
@@ -493,11 +2578,8 @@ int main() {
                             scanf("%d", &commentId);
                             getchar();
 
-                            CommentNode* found = findCommentInSystem(&system, commentId);
-                            if (found != NULL) {
-                                printf("\nҵۣ\n");
-                                displayComment(found, 0);
-                            } else {
+                            printf("\n");
+                            if (!displayCommentById(&system, commentId)) {
                                 printf("δҵIDΪ %d ۣ\n", commentId);
                             }
                             break;
@@ -509,6 +2591,19 @@ int main() {
 
                             printf("\n%s ۣ\n", author);
                             for (int i = 0; i < system.rootCount; i++) {
+                                CommentNode* root = system.rootComments[i];
+                                if (root != NULL && root->frozen != NULL) {
+                                    int offsets[100];
+                                    int count = 0;
+                                    findFrozenCommentsByAuthor(root->frozen, author,
+                                                               offsets, &count, 100);
+                                    for (int j = 0; j < count; j++) {
+                                        displayFrozenComment(root->frozen, offsets[j], 0);
+                                        printf("\n");
+                                    }
+                                    continue;
+                                }
+
                                 CommentNode* results[100];
                                 int count = 0;
                                 findCommentsByAuthor(
@@ -526,6 +2621,31 @@ int main() {
                             }
                             break;
 
+                        case 3: // ȫ
+                            printf("ݣոָʾͬʱ˫űʾ");
+                            fgets(content, MAX_CONTENT_LEN, stdin);
+                            content[strcspn(content, "\n")] = 0;
+                            {
+                                int hits[MAX_SEARCH_RESULTS];
+                                double scores[MAX_SEARCH_RESULTS];
+                                int hitCount = searchComments(&system, content, hits,
+                                                              scores, MAX_SEARCH_RESULTS);
+                                if (hitCount == 0) {
+                                    printf("δҵۣ\n");
+                                }
+                                for (int j = 0; j < hitCount; j++) {
+                                    CommentView view;
+                                    if (!getCommentView(&system, hits[j], &view)) continue;
+                                    printf("(ض %.2f) [%s] %s (: %d, ID: %d)\n",
+                                           scores[j],
+                                           view.author,
+                                           view.content,
+                                           view.likeCount,
+                                           view.id);
+                                }
+                            }
+                            break;
+
                         case 0:
                             goto main_menu;
                     }
@@ -545,35 +2665,73 @@ int main() {
                 scanf("%d", &commentId);
                 getchar();
 
-                CommentNode* target = findCommentInSystem(&system, commentId);
-                if (target != NULL) {
-                    likeComment(target);
-                } else {
-                    printf("δҵIDΪ %d ۣ\n", commentId);
-                }
+                likeCommentById(&system, commentId);
                 break;
 
             case 7: // ͳϢ
                 printf("\n========== ͳϢ ==========\n");
-                printf("%d\n", system.rootCount);
+                printf("%d\n", getRootCommentCount(&system));
                 printf("%d\n", countTotalComments(&system));
-                if (system.rootCount > 0) {
+                if (getRootCommentCount(&system) > 0) {
                     printf("ƽÿۻظ%.2f\n",
-                           (float)(countTotalComments(&system) - system.rootCount) /
-                           system.rootCount);
+                           (float)(countTotalComments(&system) - getRootCommentCount(&system)) /
+                           getRootCommentCount(&system));
                 }
                 printf("==============================\n\n");
+                dumpMetrics(stdout);
+                break;
+
+            case 8: // ҳ
+                {
+                    int pageSize, collapseDepth;
+                    printf("ÿҳ");
+                    scanf("%d", &pageSize);
+                    getchar();
+                    printf("۵ȣ0ֻۣ%dȫչ", MAX_DEPTH);
+                    scanf("%d", &collapseDepth);
+                    getchar();
+                    if (pageSize <= 0) pageSize = DEFAULT_PAGE_SIZE;
+                    if (pageSize > MAX_PAGE_SIZE) {
+                        printf("ÿҳ %d Ѱ %d ʾ\n", MAX_PAGE_SIZE, MAX_PAGE_SIZE);
+                        pageSize = MAX_PAGE_SIZE;
+                    }
+
+                    PageBuffer page;
+                    if (!initPageBuffer(&page, pageSize)) break;
+
+                    int cursor = 0;
+                    do {
+                        cursor = renderCommentPage(&system, cursor, pageSize, collapseDepth, &page);
+                        if (cursor < 0) {
+                            printf("ѱɾ޷ҳ\n");
+                            break;
+                        }
+                        fputs(page.data, stdout);
+                        if (cursor == 0) {
+                            printf("\nѵף\n");
+                            break;
+                        }
+                        printf("\nسʾһҳqأ");
+                        fgets(content, MAX_CONTENT_LEN, stdin);
+                    } while (content[0] != 'q');
+
+                    freePageBuffer(&page);
+                }
+                break;
+
+            case 9: // ᲻Ծ¥
+                printf("û»ظ¥Ҫ᣺");
+                scanf("%d", &commentId);
+                getchar();
+                printf("Ѷ %d ¥ٴλظɾʱԶⶳ޲ⶳ\n",
+                       freezeInactiveThreads(&system, commentId));
                 break;
 
             case 0: // ˳
                 printf("лʹãټ\n");
                 // ͷڴ
-                for (int i = 0; i < system.rootCount; i++) {
-                    deleteComment(system.rootComments[i]);
-                }
-                if (system.rootComments != NULL) {
-                    free(system.rootComments);
-                }
+                destroyCommentSystem(&system);
+                resetMetrics();
                 return 0;
 
             default:
@@ -1,11 +1,15 @@
 #include <stdio.h>   // printf, scanf, fgetsȣ
 #include <stdlib.h>  // ڶ̬ڴ䣨malloc, free
 #include <string.h>  // ַstrcpy, strcmp, strlenȣ
-#include <time.h>    // ɣtime, srand, rand
+#include <time.h>    // ɣtime, srand, randܲԼʱclock
 
 #define MAX_NAME_LEN 100      // 󳤶
 #define MAX_ARTIST_LEN 100    // 󳤶
 #define MAX_ALBUM_LEN 100     // ר󳤶
+#define INIT_CATALOG_CAPACITY 16  // Ŀ¼ʼ˰2ݣ
+#define INIT_INDEX_BITS 5         // ʼ 2^5 λ
+#define BENCH_SONG_COUNT 1000000  // ܲĬϵĸ
+#define LEGACY_BENCH_LIMIT 20000  // ܲ汾Եĸƽʱ䣩
 
 // Ϣṹ
 typedef struct {
@@ -24,12 +28,31 @@ typedef struct {
     return 0;
 }*/
 
-// ڵ㣨ڴ洢б
+// ڵ㣨ɰ汾ĸбֻܲڶԱȣ
 typedef struct ListNode {
     Song song;              // 洢Ϣ
     struct ListNode* next;  // ָһڵָ
 } ListNode;
 
+// Ŀ¼еһ
+typedef struct {
+    Song song;
+    unsigned int hash;      // ƵĹϣֵؽʱ㣩
+    int removed;            // 1ʾɾλȿţλ
+} CatalogEntry;
+
+// Ŀ¼˳УаƵĹϣ
+// ǿŶַ̽Ĺϣλде±+10ʾղλװʳ3/4ʱ
+// ֻͬһףӡҡɾO(1)
+typedef struct {
+    CatalogEntry* entries;  // 
+    int count;              // ʹõλɾµĿλ
+    int capacity;           // 
+    int liveCount;          // и
+    int* slots;             // 
+    int bits;               //  2^bits
+} SongCatalog;
+
 // нڵ㣨ڲŶУ
 typedef struct QueueNode {
     Song song;
@@ -68,92 +91,219 @@ ListNode* createListNode(Song song) {
     return node;
 }
 
-// ĩβӸ
-void addSongToList(ListNode** head, Song song) {
-    ListNode* newNode = createListNode(song);
-    if (newNode == NULL) return;
+// ʼĿ¼
+void initCatalog(SongCatalog* catalog) {
+    catalog->entries = NULL;  // ӵһ׸ʱ
+    catalog->count = 0;
+    catalog->capacity = 0;
+    catalog->liveCount = 0;
+    catalog->slots = NULL;
+    catalog->bits = 0;
+}
+
+// ͷŸĿ¼
+void freeCatalog(SongCatalog* catalog) {
+    free(catalog->entries);
+    free(catalog->slots);
+    initCatalog(catalog);
+}
+
+// ƵĹϣֵFNV-1a
+unsigned int hashSongName(const char* name) {
+    unsigned int hash = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)name; *p != '\0'; p++) {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    return hash;
+}
+
+// ϣֵеʼλ˷ϣȡ˻ĸbitsλ
+int catalogSlot(const SongCatalog* catalog, unsigned int hash) {
+    return (int)((hash * 2654435769u) >> (32 - catalog->bits));
+}
+
+// вڵĲλҲ-1ȱȹϣֵٱƣ
+int findCatalogSlot(const SongCatalog* catalog, const char* name, unsigned int hash) {
+    if (catalog->slots == NULL) return -1;
+
+    int mask = (1 << catalog->bits) - 1;
+    for (int i = catalogSlot(catalog, hash); catalog->slots[i] != 0; i = (i + 1) & mask) {
+        const CatalogEntry* entry = &catalog->entries[catalog->slots[i] - 1];
+        if (entry->hash == hash && strcmp(entry->song.name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// еĵindex׸һпղλ
+void indexCatalogEntry(SongCatalog* catalog, int index) {
+    int mask = (1 << catalog->bits) - 1;
+    int slot = catalogSlot(catalog, catalog->entries[index].hash);
+    while (catalog->slots[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    catalog->slots[slot] = index + 1;
+}
 
-    if (*head == NULL) {
-        // Ϊգ½ڵΪͷڵ
-        *head = newNode;
+// ؽΪ 2^newBits λʱ·䣬ʧ
+int rebuildCatalogIndex(SongCatalog* catalog, int newBits) {
+    if (catalog->slots == NULL || newBits != catalog->bits) {
+        int* newSlots = (int*)calloc(1 << newBits, sizeof(int));
+        if (newSlots == NULL) return 0;
+        free(catalog->slots);
+        catalog->slots = newSlots;
+        catalog->bits = newBits;
     } else {
-        // Ϊգҵһڵ
-        ListNode* current = *head;
-        while (current->next != NULL) {
-            current = current->next;
+        memset(catalog->slots, 0, (1 << catalog->bits) * sizeof(int));
+    }
+
+    for (int i = 0; i < catalog->count; i++) {
+        if (!catalog->entries[i].removed) {
+            indexCatalogEntry(catalog, i);
         }
-        // ½ڵӵĩβ
-        current->next = newNode;
+    }
+    return 1;
+}
+
+// 飺ȥɾµĿλԭ˳򣩣ؽ
+void compactCatalog(SongCatalog* catalog) {
+    int live = 0;
+    for (int i = 0; i < catalog->count; i++) {
+        if (!catalog->entries[i].removed) {
+            catalog->entries[live++] = catalog->entries[i];
+        }
+    }
+    catalog->count = live;
+    if (catalog->slots != NULL) {
+        rebuildCatalogIndex(catalog, catalog->bits);
+    }
+}
+
+// ӸʾĩβO(1)
+// ɹ1ͬѴڷ0ڴ治㷵-1
+int insertSong(SongCatalog* catalog, const Song* song) {
+    unsigned int hash = hashSongName(song->name);
+    if (findCatalogSlot(catalog, song->name, hash) >= 0) {
+        return 0;
+    }
+
+    // ˰2
+    if (catalog->count >= catalog->capacity) {
+        int newCapacity = (catalog->capacity == 0) ? INIT_CATALOG_CAPACITY : catalog->capacity * 2;
+        CatalogEntry* newEntries = (CatalogEntry*)realloc(catalog->entries,
+                                                          newCapacity * sizeof(CatalogEntry));
+        if (newEntries == NULL) return -1;
+        catalog->entries = newEntries;
+        catalog->capacity = newCapacity;
+    }
+    // װʳ3/4ʱֻеĸ
+    if (catalog->slots == NULL || (long long)(catalog->liveCount + 1) * 4 > (3LL << catalog->bits)) {
+        int newBits = (catalog->slots == NULL) ? INIT_INDEX_BITS : catalog->bits + 1;
+        if (!rebuildCatalogIndex(catalog, newBits)) return -1;
+    }
+
+    int index = catalog->count++;
+    catalog->entries[index].song = *song;
+    catalog->entries[index].hash = hash;
+    catalog->entries[index].removed = 0;
+    catalog->liveCount++;
+    indexCatalogEntry(catalog, index);
+    return 1;
+}
+
+// ڸĿ¼ĩβӸ
+void addSongToCatalog(SongCatalog* catalog, Song song) {
+    int result = insertSong(catalog, &song);
+    if (result == 0) {
+        printf(" \"%s\" Ѵڣ\n", song.name);
+        return;
+    }
+    if (result < 0) {
+        printf("ڴʧܣ\n");
+        return;
     }
     printf(" \"%s\" ӳɹ\n", song.name);
 }
 
 // в
 /*int main() {
-    ListNode* head = NULL;
-    Song song1, song2;
+    SongCatalog catalog;
+    initCatalog(&catalog);
+    Song song1;
 
     strcpy(song1.name, "1");
     strcpy(song1.artist, "1");
     strcpy(song1.album, "ר1");
 
-    addSongToList(&head, song1);
+    addSongToCatalog(&catalog, song1);
     // ֤Ƿӳɹ
+    freeCatalog(&catalog);
     return 0;
 }*/
 
-// ƲҸ
-ListNode* findSongInList(ListNode* head, char* name) {
-    ListNode* current = head;
-    while (current != NULL) {
-        if (strcmp(current->song.name, name) == 0) {
-            return current;  // ҵƥĸ
-        }
-        current = current->next;
+// ƲҸϣO(1)δҵNULL
+// صָһӡɾ֮ǰЧ
+Song* findSongInCatalog(SongCatalog* catalog, const char* name) {
+    int slot = findCatalogSlot(catalog, name, hashSongName(name));
+    if (slot < 0) {
+        return NULL;  // δҵ
     }
-    return NULL;  // δҵ
+    return &catalog->entries[catalog->slots[slot] - 1].song;
 }
 
-// ɾ. 0ɾʧܣ1ɾɹ
-int deleteSongFromList(ListNode** head, char* name) {
-    if (*head == NULL) {
-        printf("бΪգ\n");
-        return 0;
+// ɾһλѺ̽ϵĸŲλɾǣ
+void removeCatalogSlot(SongCatalog* catalog, int hole) {
+    int mask = (1 << catalog->bits) - 1;
+    catalog->slots[hole] = 0;
+    for (int i = (hole + 1) & mask; catalog->slots[i] != 0; i = (i + 1) & mask) {
+        // ʼλ (hole, i] ֮ĸŲ
+        int home = catalogSlot(catalog, catalog->entries[catalog->slots[i] - 1].hash);
+        int reachable = (hole < i) ? (home > hole && home <= i) : (home > hole || home <= i);
+        if (reachable) continue;
+
+        catalog->slots[hole] = catalog->slots[i];
+        catalog->slots[i] = 0;
+        hole = i;
     }
+}
 
-    ListNode* current = *head;
-    ListNode* prev = NULL;
+// ɾʾO(1)ɹ1δҵ0
+// ֻɾλһʱĴ۷̯ÿɾǳ
+int removeSong(SongCatalog* catalog, const char* name) {
+    int slot = findCatalogSlot(catalog, name, hashSongName(name));
+    if (slot < 0) {
+        return 0;
+    }
 
-    // ɾͷڵ
-    if (strcmp(current->song.name, name) == 0) {
-        *head = current->next;
-        free(current);
-        printf(" \"%s\" ɾɹ\n", name);
-        return 1;
+    int index = catalog->slots[slot] - 1;
+    removeCatalogSlot(catalog, slot);
+    catalog->entries[index].removed = 1;
+    catalog->liveCount--;
+    if ((catalog->count - catalog->liveCount) * 2 > catalog->count) {
+        compactCatalog(catalog);
     }
+    return 1;
+}
 
-    // ҪɾĽڵ
-    while (current != NULL && strcmp(current->song.name, name) != 0) {
-        prev = current;
-        current = current->next;
+// ɾ. 0ɾʧܣ1ɾɹ
+int deleteSongFromCatalog(SongCatalog* catalog, char* name) {
+    if (catalog->liveCount == 0) {
+        printf("бΪգ\n");
+        return 0;
     }
-    // 쳣жϣǰĸһָ
-    if (current == NULL) {
+
+    if (!removeSong(catalog, name)) {
         printf("δҵ \"%s\"\n", name);
         return 0;
     }
-
-    // ɾڵ㣺ǰһڵnextָǰڵnext
-    prev->next = current->next;
-    free(current);
     printf(" \"%s\" ɾɹ\n", name);
-
     return 1;
 }
 
-// ʾи
-void displayAllSongs(ListNode* head) {
-    if (head == NULL) {
+// ʾи˳˳
+void displayAllSongs(SongCatalog* catalog) {
+    if (catalog->liveCount == 0) {
         printf("бΪգ\n");
         return;
     }
@@ -163,40 +313,66 @@ void displayAllSongs(ListNode* head) {
     printf("------------------------------------------------------------\n");
 
     int index = 1;
-    ListNode* current = head;
-    // 
-    while (current != NULL) {
+    // 飬ɾµĿλ
+    for (int i = 0; i < catalog->count; i++) {
+        const CatalogEntry* entry = &catalog->entries[i];
+        if (entry->removed) continue;
         printf("%-4d %-30s %-20s %-30s\n",
                index++,
-               current->song.name,
-               current->song.artist,
-               current->song.album);
-        current = current->next;
+               entry->song.name,
+               entry->song.artist,
+               entry->song.album);
     }
     printf("================================\n\n");
 }
 
-// ޸ĸϢ
-int modifySongInList(ListNode* head, char* name) {
-    ListNode* node = findSongInList(head, name);
-    if (node == NULL) {
+// һУȥзŲµĲֶдbufferķΧ
+void readLine(char* buffer, int size) {
+    if (fgets(buffer, size, stdin) == NULL) {
+        buffer[0] = 0;
+        return;
+    }
+    size_t length = strcspn(buffer, "\n");
+    if (buffer[length] == '\n') {
+        buffer[length] = 0;
+    } else {
+        int c;
+        while ((c = getchar()) != '\n' && c != EOF) {
+            // һʣµַ
+        }
+    }
+}
+
+// ޸ĸϢʱͬʱ
+int modifySongInCatalog(SongCatalog* catalog, char* name) {
+    int slot = findCatalogSlot(catalog, name, hashSongName(name));
+    if (slot < 0) {
         printf("δҵ \"%s\"\n", name);
         return 0;
     }
+    CatalogEntry* entry = &catalog->entries[catalog->slots[slot] - 1];
 
     printf("ǰϢ\n");
-    printf("  ƣ%s\n", node->song.name);
-    printf("  ֣%s\n", node->song.artist);
-    printf("  ר%s\n", node->song.album);
+    printf("  ƣ%s\n", entry->song.name);
+    printf("  ֣%s\n", entry->song.artist);
+    printf("  ר%s\n", entry->song.album);
     printf("\nµϢ\n");
 
     // ȡ
     printf("ƣֱӻسԭֵ");
-    char newName[MAX_NAME_LEN];
-    fgets(newName, MAX_NAME_LEN, stdin);
-    newName[strcspn(newName, "\n")] = 0;  // Ƴз
-    if (strlen(newName) > 0) {
-        strcpy(node->song.name, newName);
+    char newName[sizeof(entry->song.name)];
+    readLine(newName, sizeof(newName));
+    if (strlen(newName) > 0 && strcmp(newName, entry->song.name) != 0) {
+        unsigned int hash = hashSongName(newName);
+        if (findCatalogSlot(catalog, newName, hash) >= 0) {
+            printf(" \"%s\" Ѵڣ\n", newName);
+            return 0;
+        }
+        // ȴȥƣƷŻ
+        removeCatalogSlot(catalog, slot);
+        strcpy(entry->song.name, newName);
+        entry->hash = hash;
+        indexCatalogEntry(catalog, (int)(entry - catalog->entries));
     }
 
     // Ƶشֺר...
@@ -205,32 +381,20 @@ int modifySongInList(ListNode* head, char* name) {
     return 1;
 }
 
-// ð
-void sortSongsByName(ListNode** head) {
-    if (*head == NULL || (*head)->next == NULL) {
-        return;  // ֻһڵ㣬
-    }
-
-    int swapped;
-    ListNode* ptr1;
-    ListNode* lptr = NULL;
+// Ƚ׸ƣqsort
+int compareEntriesByName(const void* a, const void* b) {
+    return strcmp(((const CatalogEntry*)a)->song.name, ((const CatalogEntry*)b)->song.name);
+}
 
-    do {
-        swapped = 0;
-        ptr1 = *head;
+// ɾµĿλqsort򣬸λñҪؽ
+void sortSongsByName(SongCatalog* catalog) {
+    if (catalog->liveCount <= 1) {
+        return;  // ûиֻһף
+    }
 
-        while (ptr1->next != lptr) {
-            if (strcmp(ptr1->song.name, ptr1->next->song.name) > 0) {
-                // ݣڵ㣬ֻݣ
-                Song temp = ptr1->song;
-                ptr1->song = ptr1->next->song;
-                ptr1->next->song = temp;
-                swapped = 1;
-            }
-            ptr1 = ptr1->next;
-        }
-        lptr = ptr1;
-    } while (swapped);
+    compactCatalog(catalog);
+    qsort(catalog->entries, catalog->count, sizeof(CatalogEntry), compareEntriesByName);
+    rebuildCatalogIndex(catalog, catalog->bits);
 
     printf("бѰ\n");
 }
@@ -417,31 +581,17 @@ void clearStack(Stack* stack) {
 Song inputSong() {
     Song song;
     printf("ƣ");
-    fgets(song.name, MAX_NAME_LEN, stdin);
-    song.name[strcspn(song.name, "\n")] = 0;
+    readLine(song.name, sizeof(song.name));
 
     printf("֣");
-    fgets(song.artist, MAX_ARTIST_LEN, stdin);
-    song.artist[strcspn(song.artist, "\n")] = 0;
+    readLine(song.artist, sizeof(song.artist));
 
     printf("ר");
-    fgets(song.album, MAX_ALBUM_LEN, stdin);
-    song.album[strcspn(song.album, "\n")] = 0;
+    readLine(song.album, sizeof(song.album));
 
     return song;
 }
 
-// ȡ
-int getListLength(ListNode* head) {
-    int count = 0;
-    ListNode* current = head;
-    while (current != NULL) {
-        count++;
-        current = current->next;
-    }
-    return count;
-}
-
 // ҲŶУϴ㷨 - Fisher-Yates㷨
 void shuffleQueue(Queue* queue) {
     if (queue->front == NULL || queue->size <= 1) {
@@ -541,14 +691,145 @@ void showQueueMenu() {
     printf("ѡ");
 }
 
-int main()
+// ܲõαxorshiftRAND_MAXСƣ
+unsigned int nextBenchRandom(unsigned int* state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// Ŀ¼ܲԣӡƲҡɾsongCount׸˳Һɾ
+// 汾ƽʱ䣬ֻǰLEGACY_BENCH_LIMIT׸ԣÿβʱ
+void runCatalogBenchmark(int songCount) {
+    if (songCount <= 0) songCount = BENCH_SONG_COUNT;
+
+    Song* songs = (Song*)malloc(songCount * sizeof(Song));
+    int* order = (int*)malloc(songCount * sizeof(int));
+    if (songs == NULL || order == NULL) {
+        printf("ڴʧܣ\n");
+        free(songs);
+        free(order);
+        return;
+    }
+    for (int i = 0; i < songCount; i++) {
+        sprintf(songs[i].name, "%d", i);
+        sprintf(songs[i].artist, "%d", i % 1000);
+        sprintf(songs[i].album, "ר%d", i % 10000);
+        order[i] = i;
+    }
+    // ҲҺɾ˳Fisher-Yatesϴ㷨
+    unsigned int state = 2463534242u;
+    for (int i = songCount - 1; i > 0; i--) {
+        int j = (int)(nextBenchRandom(&state) % (unsigned int)(i + 1));
+        int temp = order[i];
+        order[i] = order[j];
+        order[j] = temp;
+    }
+
+    printf("\n========== Ŀ¼ܲ ==========\n");
+    SongCatalog catalog;
+    initCatalog(&catalog);
+    clock_t start = clock();
+    for (int i = 0; i < songCount; i++) {
+        insertSong(&catalog, &songs[i]);
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("Ŀ¼ %d  %.3f 룬ÿ %.0f \n", songCount, seconds, seconds * 1e9 / songCount);
+
+    int found = 0;
+    start = clock();
+    for (int i = 0; i < songCount; i++) {
+        if (findSongInCatalog(&catalog, songs[order[i]].name) != NULL) found++;
+    }
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("Ŀ¼ %d  %.3f 룬ÿ %.0f 루ҵ %d ף\n",
+           songCount, seconds, seconds * 1e9 / songCount, found);
+
+    start = clock();
+    for (int i = 0; i < songCount; i++) {
+        removeSong(&catalog, songs[order[i]].name);
+    }
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("Ŀ¼ɾ %d  %.3f 룬ÿ %.0f 루ʣ %d ף\n",
+           songCount, seconds, seconds * 1e9 / songCount, catalog.liveCount);
+    freeCatalog(&catalog);
+
+    // 汾ʱߵĩβҺɾȽ
+    int legacyCount = (songCount < LEGACY_BENCH_LIMIT) ? songCount : LEGACY_BENCH_LIMIT;
+    ListNode* head = NULL;
+    start = clock();
+    for (int i = 0; i < legacyCount; i++) {
+        ListNode* node = createListNode(songs[i]);
+        if (node == NULL) break;
+        ListNode** tail = &head;
+        while (*tail != NULL) tail = &(*tail)->next;
+        *tail = node;
+    }
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf(" %d  %.3f 룬ÿ %.0f \n", legacyCount, seconds, seconds * 1e9 / legacyCount);
+
+    found = 0;
+    int queries = 0;
+    start = clock();
+    for (int i = 0; i < songCount && queries < legacyCount; i++) {
+        if (order[i] >= legacyCount) continue;
+        queries++;
+        for (ListNode* node = head; node != NULL; node = node->next) {
+            if (strcmp(node->song.name, songs[order[i]].name) == 0) {
+                found++;
+                break;
+            }
+        }
+    }
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf(" %d  %.3f 룬ÿ %.0f 루ҵ %d ף\n",
+           queries, seconds, seconds * 1e9 / queries, found);
+
+    start = clock();
+    for (int i = 0; i < songCount; i++) {
+        if (order[i] >= legacyCount) continue;
+        ListNode** link = &head;
+        while (*link != NULL && strcmp((*link)->song.name, songs[order[i]].name) != 0) {
+            link = &(*link)->next;
+        }
+        if (*link != NULL) {
+            ListNode* temp = *link;
+            *link = temp->next;
+            free(temp);
+        }
+    }
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("ɾ %d  %.3f 룬ÿ %.0f \n", queries, seconds, seconds * 1e9 / queries);
+    printf("======================================\n\n");
+
+    while (head != NULL) {
+        ListNode* temp = head;
+        head = head->next;
+        free(temp);
+    }
+    free(songs);
+    free(order);
+}
+
+int main(int argc, char *argv[])
 {
+    // в --bench []иĿ¼ܲԣĬ100ף
+    if (argc >= 2 && strcmp(argv[1], "--bench") == 0)
+    {
+        runCatalogBenchmark((argc >= 3) ? atoi(argv[2]) : 0);
+        return 0;
+    }
+
     // 1. 
-    ListNode *songList = NULL; // б
+    SongCatalog catalog;       // Ŀ¼ + 
     Queue playQueue;           // Ŷ
     Stack playHistory;         // ʷ
 
     // 2. ʼ
+    initCatalog(&catalog);
     initQueue(&playQueue);
     initStack(&playHistory);
     srand((unsigned int)time(NULL)); // ʼ
@@ -580,32 +861,32 @@ int main()
                 {
                 case 1: // Ӹ
                     song = inputSong();
-                    addSongToList(&songList, song);
+                    addSongToCatalog(&catalog, song);
                     break;
                 case 2: // ɾ
                     printf("Ҫɾĸƣ");
                     fgets(name, MAX_NAME_LEN, stdin);
                     name[strcspn(name, "\n")] = 0;
-                    deleteSongFromList(&songList, name);
+                    deleteSongFromCatalog(&catalog, name);
                     break;
                 case 3: // ޸ĸ
                     printf("Ҫ޸ĵĸƣ");
                     fgets(name, MAX_NAME_LEN, stdin);
                     name[strcspn(name, "\n")] = 0;
-                    modifySongInList(songList, name);
+                    modifySongInCatalog(&catalog, name);
                     break;
                 case 4: // ѯ
                     printf("Ҫѯĸƣ");
                     fgets(name, MAX_NAME_LEN, stdin);
                     name[strcspn(name, "\n")] = 0;
                     {
-                        ListNode *found = findSongInList(songList, name);
+                        Song *found = findSongInCatalog(&catalog, name);
                         if (found != NULL)
                         {
                             printf("\nҵ\n");
-                            printf("  ƣ%s\n", found->song.name);
-                            printf("  ֣%s\n", found->song.artist);
-                            printf("  ר%s\n", found->song.album);
+                            printf("  ƣ%s\n", found->name);
+                            printf("  ֣%s\n", found->artist);
+                            printf("  ר%s\n", found->album);
                         }
                         else
                         {
@@ -614,10 +895,10 @@ int main()
                     }
                     break;
                 case 5: // ʾи
-                    displayAllSongs(songList);
+                    displayAllSongs(&catalog);
                     break;
                 case 6: // 
-                    sortSongsByName(&songList);
+                    sortSongsByName(&catalog);
                     break;
                 case 0: // ˵
                     goto main_menu;
@@ -641,10 +922,10 @@ int main()
                     fgets(name, MAX_NAME_LEN, stdin);
                     name[strcspn(name, "\n")] = 0;
                     {
-                        ListNode *found = findSongInList(songList, name);
+                        Song *found = findSongInCatalog(&catalog, name);
                         if (found != NULL)
                         {
-                            enqueue(&playQueue, found->song);
+                            enqueue(&playQueue, *found);
                         }
                         else
                         {
@@ -693,13 +974,8 @@ int main()
 
         case 0: // ˳
             printf("лʹãټ\n");
-            // ͷڴ
-            while (songList != NULL)
-            {
-                ListNode *temp = songList;
-                songList = songList->next;
-                free(temp);
-            }
+            // ͷŸĿ¼ڴ
+            freeCatalog(&catalog);
             // ͷŶڴ
             clearQueue(&playQueue);
             // ͷջڴ
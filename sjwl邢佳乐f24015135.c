@@ -2,30 +2,244 @@
 #include <stdlib.h>  // ڶ̬ڴ䣨malloc, free
 #include <string.h>  // ַstrcpy, strcmp, strncpyȣ
 #include <stdbool.h> // ڲͣbool, true, false
-#define MAX_USERS 1000      // û
+#include <limits.h>  // INT_MAXļʱûIDͺѹϵ
+#include <time.h>    // ܲԼʱclockͳΪѵʱ䣨time
+#include <math.h>    // ȻlogAdamic-Adar÷֣ʱ -lm
+#if defined(__SSE2__)
+#include <emmintrin.h> // SSE2ָͬѵĽ㣩
+#endif
+#ifndef ENABLE_CONCURRENT_GRAPH
+#if defined(__STDC_NO_THREADS__) || defined(__STDC_NO_ATOMICS__) || defined(_WIN32)
+#define ENABLE_CONCURRENT_GRAPH 0
+#else
+#define ENABLE_CONCURRENT_GRAPH 1 // ģʽأ֧C11߳ʱԶرգҲɼ -DENABLE_CONCURRENT_GRAPH=0
+#endif
+#endif
+#if ENABLE_CONCURRENT_GRAPH
+#include <threads.h>   // C11̣߳ϲ̡߳
+#include <stdatomic.h> // ԭӱաߵǼʹõĿգ
+#endif
+#define INIT_USER_CAPACITY 16 // ûʼû˰2ݣ
 #define MAX_NAME_LEN 64    // û󳤶
+#define LEGACY_BENCH_LIMIT 20000 // ûֵʱܲԲͬʱ汾
+#define GALLOP_RATIO 32          // бʱԾ󽻼
+#define HUB_BITMAP_RATIO 32      //  * HUB_BITMAP_RATIO >= ûʱΪûλͼ
+#define DEFAULT_RECOMMEND_COUNT 10 // ƼĬʾ
+#define INIT_PENDING_CAPACITY 64 // ׷ӻʼ
+#define MIN_PENDING_MERGE 1024   // ׷ӻܵô¼źϲCSR
+#define PENDING_INSERT_LIMIT 8   // ϲʱһеºѲôУ
+#define INIT_EDGE_SET_BITS 10    // ѹϵϣϳʼΪ 2^10 λ
+#define CIRCLE_HISTOGRAM_BUCKETS 32 // Ȧֲ1ˡ2ˡ3-4ˡ5-8ˡ
+#define INIT_EDGE_LIST_CAPACITY 1024 // ѹϵбʱĳʼ
+#define LOAD_BUFFER_SIZE (1 << 20)   // ļʱÿζֽ
+#define MAX_USER_CAPACITY (1 << 30)  // ѹϵбͶͼʱûޣٷint
+#define IMPORT_REMAP_RATIO 4         // ļеûIDͬIDô౶ʱIDС±Ϊ1..n
+#define SNAPSHOT_MAGIC 0x4C57534AU   // ͼļͷıʶ
+#define SNAPSHOT_VERSION 1
+#define MAX_FILE_NAME_LEN 256        // ļ󳤶
+#define MULTI_SOURCE_BATCH 64        // ·һBFSͬʱһ64λֵλ
+#define PAGERANK_DAMPING 0.85        // PageRankϵ
+#define PAGERANK_MAX_ITERATIONS 50   // PageRank
+#define PAGERANK_TOLERANCE 1e-6      // PageRank֮ֵ֮ͣСֵʱֹͣ
+#define INFLUENCE_TOP_COUNT 10       // Ӱʾ
+#define INIT_NAME_INDEX_BITS 10      // ûϣʼΪ 2^10 λ
+#define INIT_FREE_ID_CAPACITY 16     // ûIDջĳʼ
+#define NAME_SEARCH_LIMIT 20         // Ʋʱʾû
+#define BOTTOM_UP_ALPHA 14            // ĺѼ¼ * ALPHA δûĺѼ¼ʱΪԵչ
+#define BOTTOM_UP_BETA 24             // ǰ * BETA ûʱĻԶչ
+#define NEIGHBORHOOD_DISPLAY_LIMIT 50 // Nںʱʾ
+#define DEFAULT_FRIEND_WEIGHT 1       // ѹϵĬȨأȨ·еı߳
+#define STRONG_TIE_COUNT 10           // ÿû¼ܺ
+#define RADIX_HEAP_BUCKETS 65         // ѵͰ64λļϴȡļͬ0Ͱ
+#define INIT_RADIX_BUCKET_CAPACITY 16 // ÿͰĳʼ
+#define SNAPSHOT_ATTR_MAGIC 0x52545441U // ͼĩβԲֵıʶûм¼ԵĿûһ֣
+#define SECONDS_PER_DAY 86400
+#define HEAVY_QUERY_RATIO 100         // ۺܲҪͼĲBFSȦֻ 1/100 Ĵ
+#define MAX_READER_THREADS 64        // ģʽͬʱǼǵĶ߳ޣ߳̽ǰȡǼǣλÿã
+#define INIT_MUTATION_CAPACITY 1024  // ģʽдеĳʼ
+#define DEFAULT_MAX_STALENESS_MS 50  // ģʽĬϵĿӳ٣ϲ߳ȡôд
+#define DEFAULT_MERGE_BATCH 4096     // ģʽдܹôϲдڶһʱȴ
+#define MAX_PUBLISH_BATCH 512        // ģʽһηдȡĸʱּη
+#define MIN_QUEUE_LIMIT 256          // ģʽٶƶгʱ
+#define MIN_COMPACT_ROWS 64          // ģʽÿη˳¸ôУջؾɿвõĿռ
 // ûڵ
 typedef struct User {
     int id;                      // ûIDΨһʶ
     char name[MAX_NAME_LEN];     // û
     bool exists;                 // ûǷڣ
+    bool hasHubBitmap;           // Ƿ񻺴˺λͼVûУ
 } User;
-// ͼڽӱڵ㣨ڵ㣩
+// ͼڽӱڵ㣨ڵ㣬ɰ汾Ĵ洢ʽֻܲڶԱȣ
 typedef struct AdjListNode {
     int userId;                  // ѵûID
     struct AdjListNode* next;    // ָһѽڵ
 } AdjListNode;
-// ͼڽӱÿûĺб
-typedef struct AdjList {
-    AdjListNode* head;  // ͷָ
-} AdjList;
-// ͼṹ
+// ѹϵϣϣŶַ̽⣬ (СID << 32) | ϴID0ʾղλ
+// װʳ3/4ʱɾʱѺļǰŲɾǣ
+typedef struct {
+    unsigned long long* keys;
+    int bits;                    //  2^bits
+    int count;                   // ѹϵÿֻһΣ
+} EdgeSet;
+
+// ѹϵԣÿѹϵ˫ĺиһݣʼͬ
+typedef struct {
+    int weight;                  // ȨأȨ·еı߳ĬDEFAULT_FRIEND_WEIGHT
+    int interactions;            // ԽϵԽܣ
+    long long createdAt;         // Ϊѵʱ䣨룩ʼ¼֮ǰеĺΪ0
+} EdgeAttr;
+
+// ܺеһ
+typedef struct {
+    int friendId;
+    int interactions;
+} StrongTie;
+
+// ûϣŶַ̽⣬һλһûͬûռһλ0ʾղλ
+// ͬʱƵĹϣֵ̽ʱȱȹϣٱƣװʳ3/4ʱ
+typedef struct {
+    int* ids;
+    unsigned int* hashes;
+    int bits;                    //  2^bits
+    int count;
+} NameIndex;
+
+// ͼṹѹϵCSRѹϡУУ¼ӵĺȽ׷ӻܹϲ
 typedef struct Graph {
-    User users[MAX_USERS];      // û
-    AdjList adjLists[MAX_USERS]; // ڽӱ
+    User* users;                 // û飨ûID±ʣݣ
+    int userCapacity;            // û
     int userCount;               // ǰû
     int nextId;                  // һõûID
+
+    // CSRգûuĺ neighbors[rowStart[u]] ʼ baseDegree[u] ID
+    int* rowStart;               // ÿûneighborsеʼλãuserCapacity + 1
+    int* baseDegree;             // ÿûеĺɾѺСڷֵĳȣ
+    int* neighbors;              // ûĺ
+    int baseEdgeCount;           // еĺѼ¼ÿѹϵΣ
+
+    // ׷ӻͬһû¼ӵĺѴpendingHead[u]ӵһ
+    int* pendingHead;            // ÿûͷڻе±꣬-1ʾû
+    int* pendingFriend;          // ÿ¼ĺID
+    int* pendingNext;            // ͬһûһ¼-1ʾβ
+    int pendingCount;            // ʹõļ¼ɾµĿλ
+    int pendingCapacity;         // 
+    int pendingLive;             // Чļ¼
+
+    EdgeSet edgeSet;             // кѹϵжǷǺѲɨб
+
+    // ԣѡneighborAttrneighborsһһӦpendingAttrpendingFriendһһӦ
+    // ĴͼĬϲ¼ΪNULLÿѹϵȨض1enableEdgeAttributesʼ¼
+    EdgeAttr* neighborAttr;
+    EdgeAttr* pendingAttr;
+    StrongTie* strongTies;       // ûuĺѴ strongTies[u * STRONG_TIE_COUNT] ʼӶൽ
+    int* strongTieCount;         // ÿûֻܺ㻥ĺѣSTRONG_TIE_COUNT
+
+    // ͳƣɾʱʱ£ͳϢб
+    int* degree;                 // ÿûĺuserCapacity
+    int* degreeHistogram;        // degreeHistogram[d]ǺΪdûuserCapacity
+    int maxDegree;               // ǰ
+
+    // Ȧ鼯ӺʱϲڵȦɾѿܲȦֻʧЧѯʱؽ
+    int* circleParent;           // 鼯еĸڵ㣨userCapacity
+    int* circleSize;             // ԸûΪȦֻԸЧ
+    bool circlesValid;           // 鼯Ƿ뵱ǰѹϵһ
+
+    // ûɾ
+    NameIndex nameIndex;         // ƾȷû
+    int* nameOrder;              // ûIDǰ׺ãû仯ʧЧʱţ
+    int nameOrderCount;
+    bool nameOrderValid;
+    int* freeIds;                // ɾûճIDûʱȸ
+    int freeCount;
+    int freeCapacity;
+
+    // VûĺλͼvλΪ1ʾvǺѣѹϵ仯ʱ
+    // ֻкﵽû1/HUB_BITMAP_RATIOûŻ棬λͼȺб
+    struct HubBitmap* hubBitmaps;
+    int hubCount;
+    int hubCapacity;
 } Graph;
+
+// Vûĺλͼ
+typedef struct HubBitmap {
+    int userId;
+    int bitCount;                // λͼǵûIDΧ [0, bitCount)
+    unsigned long long* bits;
+} HubBitmap;
+
+// ѱȱCSRе򲿷֣ٱ׷ӻ
+typedef struct {
+    const int* base;             // һ
+    int baseLeft;                // ʣĺ
+    const Graph* graph;
+    int pending;                 // еһ¼-1ʾ
+} FriendIterator;
+
+// ѯõʱ飺ÿ߳һݣѯ֮临
+// visitMark[u] == epoch ʾβѯѷuÿβѯֻepoch1
+typedef struct {
+    unsigned int* visitMark;
+    unsigned int epoch;
+    int* queue;                  // BFS
+    int* parent;                 // BFSеĸڵ㣨ֻԱѷʵûЧ
+    unsigned int* backMark;      // ˫BFSдյһķʱ
+    int* backQueue;              // ˫BFSдյһĶ
+    int* backParent;             // ˫BFSдյһĸڵ㣨ָյ㷽
+    double* score;               // Ƽѵĵ÷ۼֻԱvisitMarkǹûЧ
+    int* mutual;                 // ƼѵĹͬۼ
+    unsigned long long* frontierBits; // ԵBFSеǰλͼuλΪ1ʾuڵǰ㣩
+    long long* cost;             // Ȩ·еÿûĵǰ̾루ֻԱvisitMarkǹûЧ
+    int capacity;                // 鳤ȣСͼû
+    int visitedCount;            // һ·ѯʵûܶԱȣ
+} SearchScratch;
+
+// ʱĺѹϵбfrom[i]to[i]һԺѣ
+typedef struct {
+    int* from;
+    int* to;
+    long long count;
+    long long capacity;
+    int maxId;                   // ֹûID
+} EdgeList;
+
+// ʱûID±ţֹIDСαΪ1..nIDλͼв1ĸ
+typedef struct {
+    unsigned long long* present; // xλΪ1ʾID xļгֹ
+    int* prefix;                 // prefix[w]w64λ֮ǰ1ĸIDҪ±ʱΪNULL
+    int distinct;                // ֹĲͬID
+} IdRemap;
+
+// ͼļͷǣû飨nextIdUserÿûĺnextIdint
+// ûĺѣû˳ÿ򣩡ѹϵϣϣ2^edgeSetBitsλʱɺؽ
+// ¼˱ʱSNAPSHOT_ATTR_MAGICкһһӦıԣʱһֿпޣ
+// ֶǶԭʼ飬
+typedef struct {
+    unsigned int magic;
+    int version;
+    int nextId;
+    int userCount;
+    int edgeSetBits;
+    int edgeSetCount;
+    long long neighborCount;     // Ѽ¼ÿѹϵ
+} SnapshotHeader;
+
+// һƼ
+typedef struct {
+    int userId;
+    int mutualCount;             // ͬ
+    double score;                // Adamic-Adar÷֣ÿͬѹ 1/ln(úѵĺ)
+} Recommendation;
+
+// ·еһѯdistancefromtoĶ0ԼɴûΪ-1
+typedef struct {
+    int from;
+    int to;
+    int distance;
+} PathQuery;
+
+// NȺѲѯĻصÿҵһûһΣdistanceľ루Ⱥѣ
+// falseʾҪѯ
+typedef bool (*NeighborhoodVisitor)(int userId, int distance, void* context);
 // вԽṹ
 /*int main() {
     Graph* graph = (Graph*)malloc(sizeof(Graph));
@@ -33,8 +247,8 @@ typedef struct Graph {
     free(graph);
     return 0;
 }*/
-// ʼͼ
-Graph* initGraph() {
+// ͼûΪuserCapacity
+Graph* createGraph(int userCapacity) {
     Graph* graph = (Graph*)malloc(sizeof(Graph));
     if (graph == NULL) {
         printf("ڴʧܣ\n");
@@ -43,15 +257,277 @@ Graph* initGraph() {
 
     graph->userCount = 0;
     graph->nextId = 1;
+    graph->userCapacity = userCapacity;
+
+    // CSRһʼǿյģ׷ӻڵһμӺʱ
+    graph->users = (User*)calloc(userCapacity, sizeof(User));  // existsȫΪfalse
+    graph->rowStart = (int*)calloc(userCapacity + 1, sizeof(int));
+    graph->baseDegree = (int*)calloc(userCapacity, sizeof(int));
+    graph->pendingHead = (int*)malloc(userCapacity * sizeof(int));
+    graph->neighbors = NULL;
+    graph->baseEdgeCount = 0;
+    graph->pendingFriend = NULL;
+    graph->pendingNext = NULL;
+    graph->pendingCount = 0;
+    graph->pendingCapacity = 0;
+    graph->pendingLive = 0;
+    graph->edgeSet.keys = NULL;  // һμӺʱ
+    graph->edgeSet.bits = 0;
+    graph->edgeSet.count = 0;
+    graph->neighborAttr = NULL;  // enableEdgeAttributesŷ
+    graph->pendingAttr = NULL;
+    graph->strongTies = NULL;
+    graph->strongTieCount = NULL;
+    graph->degree = (int*)calloc(userCapacity, sizeof(int));
+    graph->degreeHistogram = (int*)calloc(userCapacity, sizeof(int));
+    graph->maxDegree = 0;
+    graph->circleParent = (int*)malloc(userCapacity * sizeof(int));
+    graph->circleSize = (int*)malloc(userCapacity * sizeof(int));
+    graph->circlesValid = true;
+    graph->nameIndex.ids = NULL;  // һûʱ
+    graph->nameIndex.hashes = NULL;
+    graph->nameIndex.bits = 0;
+    graph->nameIndex.count = 0;
+    graph->nameOrder = NULL;
+    graph->nameOrderCount = 0;
+    graph->nameOrderValid = false;
+    graph->freeIds = NULL;
+    graph->freeCount = 0;
+    graph->freeCapacity = 0;
+    graph->hubBitmaps = NULL;
+    graph->hubCount = 0;
+    graph->hubCapacity = 0;
+    if (graph->users == NULL || graph->rowStart == NULL || graph->baseDegree == NULL ||
+        graph->pendingHead == NULL || graph->degree == NULL || graph->degreeHistogram == NULL ||
+        graph->circleParent == NULL || graph->circleSize == NULL) {
+        printf("ڴʧܣ\n");
+        free(graph->users);
+        free(graph->rowStart);
+        free(graph->baseDegree);
+        free(graph->pendingHead);
+        free(graph->degree);
+        free(graph->degreeHistogram);
+        free(graph->circleParent);
+        free(graph->circleSize);
+        free(graph);
+        return NULL;
+    }
+
+    // ÿûһʼԳһȦ
+    for (int i = 0; i < userCapacity; i++) {
+        graph->pendingHead[i] = -1;
+        graph->circleParent[i] = i;
+        graph->circleSize[i] = 1;
+    }
 
-    // ʼûڽӱ
-    for (int i = 0; i < MAX_USERS; i++) {
-        graph->users[i].exists = false;
-        graph->adjLists[i].head = NULL;
+    return graph;
+}
+// ʼ¼ԣеĺѹϵȡĬȨءûлΪѵʱδ֪Ϊ0
+// ɹ1ڴ治㷵0ͼȻ¼ԣ
+int enableEdgeAttributes(Graph* graph) {
+    if (graph->neighborAttr != NULL) return 1;
+
+    int neighborSlots = graph->rowStart[graph->userCapacity];  // ո֮ɾµĿλ
+    EdgeAttr* neighborAttr = (EdgeAttr*)malloc((neighborSlots > 0 ? neighborSlots : 1) * sizeof(EdgeAttr));
+    EdgeAttr* pendingAttr = (EdgeAttr*)malloc(
+        (graph->pendingCapacity > 0 ? graph->pendingCapacity : 1) * sizeof(EdgeAttr));
+    StrongTie* strongTies = (StrongTie*)malloc(
+        (long long)graph->userCapacity * STRONG_TIE_COUNT * sizeof(StrongTie));
+    int* strongTieCount = (int*)calloc(graph->userCapacity, sizeof(int));
+    if (neighborAttr == NULL || pendingAttr == NULL || strongTies == NULL || strongTieCount == NULL) {
+        free(neighborAttr);
+        free(pendingAttr);
+        free(strongTies);
+        free(strongTieCount);
+        return 0;
     }
 
+    EdgeAttr initial = {DEFAULT_FRIEND_WEIGHT, 0, 0};
+    for (int i = 0; i < neighborSlots; i++) neighborAttr[i] = initial;
+    for (int i = 0; i < graph->pendingCount; i++) pendingAttr[i] = initial;
+    graph->neighborAttr = neighborAttr;
+    graph->pendingAttr = pendingAttr;
+    graph->strongTies = strongTies;
+    graph->strongTieCount = strongTieCount;
+    return 1;
+}
+// ʼͼʹõͼ¼ԣڴ治ʱ¼
+Graph* initGraph() {
+    Graph* graph = createGraph(INIT_USER_CAPACITY);
+    if (graph != NULL) enableEdgeAttributes(graph);
     return graph;
 }
+// ͷͼڴ
+void freeGraph(Graph* graph) {
+    if (graph == NULL) return;
+
+    free(graph->users);
+    free(graph->rowStart);
+    free(graph->baseDegree);
+    free(graph->neighbors);
+    free(graph->pendingHead);
+    free(graph->pendingFriend);
+    free(graph->pendingNext);
+    free(graph->edgeSet.keys);
+    free(graph->neighborAttr);
+    free(graph->pendingAttr);
+    free(graph->strongTies);
+    free(graph->strongTieCount);
+    free(graph->degree);
+    free(graph->degreeHistogram);
+    free(graph->circleParent);
+    free(graph->circleSize);
+    free(graph->nameIndex.ids);
+    free(graph->nameIndex.hashes);
+    free(graph->nameOrder);
+    free(graph->freeIds);
+    for (int i = 0; i < graph->hubCount; i++) {
+        free(graph->hubBitmaps[i].bits);
+    }
+    free(graph->hubBitmaps);
+    free(graph);
+}
+// ûݣû±ʵһ
+int growUsers(Graph* graph) {
+    int oldCapacity = graph->userCapacity;
+    int newCapacity = oldCapacity * 2;
+
+    User* newUsers = (User*)realloc(graph->users, newCapacity * sizeof(User));
+    if (newUsers == NULL) return 0;
+    graph->users = newUsers;
+    int* newRowStart = (int*)realloc(graph->rowStart, (newCapacity + 1) * sizeof(int));
+    if (newRowStart == NULL) return 0;
+    graph->rowStart = newRowStart;
+    int* newBaseDegree = (int*)realloc(graph->baseDegree, newCapacity * sizeof(int));
+    if (newBaseDegree == NULL) return 0;
+    graph->baseDegree = newBaseDegree;
+    int* newPendingHead = (int*)realloc(graph->pendingHead, newCapacity * sizeof(int));
+    if (newPendingHead == NULL) return 0;
+    graph->pendingHead = newPendingHead;
+    int* newDegree = (int*)realloc(graph->degree, newCapacity * sizeof(int));
+    if (newDegree == NULL) return 0;
+    graph->degree = newDegree;
+    int* newHistogram = (int*)realloc(graph->degreeHistogram, newCapacity * sizeof(int));
+    if (newHistogram == NULL) return 0;
+    graph->degreeHistogram = newHistogram;
+    int* newCircleParent = (int*)realloc(graph->circleParent, newCapacity * sizeof(int));
+    if (newCircleParent == NULL) return 0;
+    graph->circleParent = newCircleParent;
+    int* newCircleSize = (int*)realloc(graph->circleSize, newCapacity * sizeof(int));
+    if (newCircleSize == NULL) return 0;
+    graph->circleSize = newCircleSize;
+    if (graph->strongTies != NULL) {
+        StrongTie* newTies = (StrongTie*)realloc(graph->strongTies,
+                                                 (long long)newCapacity * STRONG_TIE_COUNT * sizeof(StrongTie));
+        if (newTies == NULL) return 0;
+        graph->strongTies = newTies;
+        int* newTieCount = (int*)realloc(graph->strongTieCount, newCapacity * sizeof(int));
+        if (newTieCount == NULL) return 0;
+        graph->strongTieCount = newTieCount;
+        memset(graph->strongTieCount + oldCapacity, 0, (newCapacity - oldCapacity) * sizeof(int));
+    }
+
+    // ûڿжǿУڿĩβ
+    memset(graph->users + oldCapacity, 0, (newCapacity - oldCapacity) * sizeof(User));
+    for (int i = oldCapacity; i < newCapacity; i++) {
+        graph->rowStart[i + 1] = graph->rowStart[oldCapacity];
+        graph->baseDegree[i] = 0;
+        graph->pendingHead[i] = -1;
+        graph->degree[i] = 0;
+        graph->degreeHistogram[i] = 0;
+        graph->circleParent[i] = i;
+        graph->circleSize[i] = 1;
+    }
+    graph->userCapacity = newCapacity;
+    return 1;
+}
+// ǰʱ䣨룩
+long long currentNanos() {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+// жûIDǷЧ
+bool isValidUser(const Graph* graph, int userId) {
+    return userId > 0 && userId < graph->nextId && graph->users[userId].exists;
+}
+// ȡǰ̵߳Ĳѯʱ飬capacityʱݣ㣩
+static _Thread_local SearchScratch threadScratch;
+SearchScratch* reserveSearchScratch(int capacity) {
+    SearchScratch* scratch = &threadScratch;
+    if (scratch->capacity >= capacity) {
+        return scratch;
+    }
+
+    int newCapacity = capacity;
+    unsigned int* newMark = (unsigned int*)realloc(scratch->visitMark,
+                                                   newCapacity * sizeof(unsigned int));
+    if (newMark == NULL) return NULL;
+    scratch->visitMark = newMark;
+    int* newQueue = (int*)realloc(scratch->queue, newCapacity * sizeof(int));
+    if (newQueue == NULL) return NULL;
+    scratch->queue = newQueue;
+    int* newParent = (int*)realloc(scratch->parent, newCapacity * sizeof(int));
+    if (newParent == NULL) return NULL;
+    scratch->parent = newParent;
+    newMark = (unsigned int*)realloc(scratch->backMark, newCapacity * sizeof(unsigned int));
+    if (newMark == NULL) return NULL;
+    scratch->backMark = newMark;
+    newQueue = (int*)realloc(scratch->backQueue, newCapacity * sizeof(int));
+    if (newQueue == NULL) return NULL;
+    scratch->backQueue = newQueue;
+    newParent = (int*)realloc(scratch->backParent, newCapacity * sizeof(int));
+    if (newParent == NULL) return NULL;
+    scratch->backParent = newParent;
+    double* newScore = (double*)realloc(scratch->score, newCapacity * sizeof(double));
+    if (newScore == NULL) return NULL;
+    scratch->score = newScore;
+    int* newMutual = (int*)realloc(scratch->mutual, newCapacity * sizeof(int));
+    if (newMutual == NULL) return NULL;
+    scratch->mutual = newMutual;
+    unsigned long long* newBits = (unsigned long long*)realloc(
+        scratch->frontierBits, ((newCapacity + 63) / 64) * sizeof(unsigned long long));
+    if (newBits == NULL) return NULL;
+    scratch->frontierBits = newBits;
+    long long* newCost = (long long*)realloc(scratch->cost, newCapacity * sizeof(long long));
+    if (newCost == NULL) return NULL;
+    scratch->cost = newCost;
+
+    memset(scratch->visitMark + scratch->capacity, 0,
+           (newCapacity - scratch->capacity) * sizeof(unsigned int));
+    memset(scratch->backMark + scratch->capacity, 0,
+           (newCapacity - scratch->capacity) * sizeof(unsigned int));
+    scratch->capacity = newCapacity;
+    return scratch;
+}
+// ȡǰ̵߳Ĳѯʱ飬Ϊͼû
+SearchScratch* getSearchScratch(const Graph* graph) {
+    return reserveSearchScratch(graph->userCapacity);
+}
+// ʼһµĲѯepoch1֮ǰķʱȫʧЧ
+void beginVisit(SearchScratch* scratch) {
+    scratch->epoch++;
+    if (scratch->epoch == 0) {
+        // ƻ0ʱһΣܾǰıǳͻ
+        memset(scratch->visitMark, 0, scratch->capacity * sizeof(unsigned int));
+        memset(scratch->backMark, 0, scratch->capacity * sizeof(unsigned int));
+        scratch->epoch = 1;
+    }
+}
+// ͷŵǰ̵߳Ĳѯʱ
+void freeSearchScratch() {
+    free(threadScratch.visitMark);
+    free(threadScratch.queue);
+    free(threadScratch.parent);
+    free(threadScratch.backMark);
+    free(threadScratch.backQueue);
+    free(threadScratch.backParent);
+    free(threadScratch.score);
+    free(threadScratch.mutual);
+    free(threadScratch.frontierBits);
+    free(threadScratch.cost);
+    memset(&threadScratch, 0, sizeof(threadScratch));
+}
 // ڽӱڵ
 AdjListNode* createAdjListNode(int userId) {
     AdjListNode* node = (AdjListNode*)malloc(sizeof(AdjListNode));
@@ -65,19 +541,222 @@ AdjListNode* createAdjListNode(int userId) {
 
     return node;
 }
-// û
-int addUser(Graph* graph, const char* name) {
-    if (graph->userCount >= MAX_USERS) {
-        printf("ûѴޣ\n");
+// ûĹϣֵFNV-1a
+unsigned int hashName(const char* name) {
+    unsigned int hash = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)name; *p != '\0'; p++) {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    return hash;
+}
+// ϣֵеʼλ
+int nameSlot(const NameIndex* index, unsigned int hash) {
+    return (int)((hash * 2654435769u) >> (32 - index->bits));
+}
+// ݵ 2^newBits λ
+int resizeNameIndex(NameIndex* index, int newBits) {
+    int* newIds = (int*)calloc(1 << newBits, sizeof(int));
+    unsigned int* newHashes = (unsigned int*)malloc((1 << newBits) * sizeof(unsigned int));
+    if (newIds == NULL || newHashes == NULL) {
+        free(newIds);
+        free(newHashes);
+        return 0;
+    }
+
+    int* oldIds = index->ids;
+    unsigned int* oldHashes = index->hashes;
+    int oldCapacity = (oldIds == NULL) ? 0 : (1 << index->bits);
+    index->ids = newIds;
+    index->hashes = newHashes;
+    index->bits = newBits;
+
+    int mask = (1 << newBits) - 1;
+    for (int i = 0; i < oldCapacity; i++) {
+        if (oldIds[i] == 0) continue;
+        int slot = nameSlot(index, oldHashes[i]);
+        while (newIds[slot] != 0) slot = (slot + 1) & mask;
+        newIds[slot] = oldIds[i];
+        newHashes[slot] = oldHashes[i];
+    }
+    free(oldIds);
+    free(oldHashes);
+    return 1;
+}
+// ֤ٷһûڴ治㷵0
+int reserveNameIndex(NameIndex* index) {
+    if (index->ids != NULL && (long long)(index->count + 1) * 4 <= (3LL << index->bits)) {
+        return 1;
+    }
+    return resizeNameIndex(index, (index->ids == NULL) ? INIT_NAME_INDEX_BITS : index->bits + 1);
+}
+// ûǰreserveNameIndex
+void addToNameIndex(Graph* graph, int userId) {
+    NameIndex* index = &graph->nameIndex;
+    unsigned int hash = hashName(graph->users[userId].name);
+    int mask = (1 << index->bits) - 1;
+    int slot = nameSlot(index, hash);
+    while (index->ids[slot] != 0) slot = (slot + 1) & mask;
+    index->ids[slot] = userId;
+    index->hashes[slot] = hash;
+    index->count++;
+}
+// ûɾ̽ϵûǰŲɾǣ
+void removeFromNameIndex(Graph* graph, int userId) {
+    NameIndex* index = &graph->nameIndex;
+    int mask = (1 << index->bits) - 1;
+    int hole = nameSlot(index, hashName(graph->users[userId].name));
+    while (index->ids[hole] != userId) {
+        if (index->ids[hole] == 0) return;  // 
+        hole = (hole + 1) & mask;
+    }
+
+    index->ids[hole] = 0;
+    for (int i = (hole + 1) & mask; index->ids[i] != 0; i = (i + 1) & mask) {
+        int home = nameSlot(index, index->hashes[i]);
+        bool reachable = (hole < i) ? (home > hole && home <= i) : (home > hole || home <= i);
+        if (reachable) continue;
+
+        index->ids[hole] = index->ids[i];
+        index->hashes[hole] = index->hashes[i];
+        index->ids[i] = 0;
+        hole = i;
+    }
+    index->count--;
+}
+// ƾȷûO(1)ͬûдidsmaxCountҵĸ
+int findUsersByName(const Graph* graph, const char* name, int* ids, int maxCount) {
+    const NameIndex* index = &graph->nameIndex;
+    if (index->ids == NULL) return 0;
+
+    unsigned int hash = hashName(name);
+    int mask = (1 << index->bits) - 1;
+    int count = 0;
+    for (int i = nameSlot(index, hash); index->ids[i] != 0 && count < maxCount; i = (i + 1) & mask) {
+        if (index->hashes[i] == hash && strcmp(graph->users[index->ids[i]].name, name) == 0) {
+            ids[count++] = index->ids[i];
+        }
+    }
+    return count;
+}
+// ƱȽûqsortͬİID
+int compareUsersByName(const void* a, const void* b) {
+    const User* userA = *(const User* const*)a;
+    const User* userB = *(const User* const*)b;
+    int result = strcmp(userA->name, userB->name);
+    if (result != 0) return result;
+    return (userA->id > userB->id) - (userA->id < userB->id);
+}
+// ɰûбڴ治㷵0
+int rebuildNameOrder(Graph* graph) {
+    int* order = (int*)realloc(graph->nameOrder, (graph->userCount > 0 ? graph->userCount : 1) * sizeof(int));
+    const User** users = (const User**)malloc((graph->userCount > 0 ? graph->userCount : 1) * sizeof(User*));
+    if (order == NULL || users == NULL) {
+        if (order != NULL) graph->nameOrder = order;
+        free(users);
+        return 0;
+    }
+    graph->nameOrder = order;
+
+    int count = 0;
+    for (int u = 1; u < graph->nextId; u++) {
+        if (graph->users[u].exists) users[count++] = &graph->users[u];
+    }
+    qsort(users, count, sizeof(User*), compareUsersByName);
+    for (int i = 0; i < count; i++) {
+        order[i] = users[i]->id;
+    }
+    free(users);
+
+    graph->nameOrderCount = count;
+    graph->nameOrderValid = true;
+    return 1;
+}
+// ǰ׺ûڰбжҵһСǰ׺ƣȡǰ׺ͬ
+// û仯һβҪ򣻽˳дidsmaxCountظ
+int findUsersByPrefix(Graph* graph, const char* prefix, int* ids, int maxCount) {
+    if (!graph->nameOrderValid && !rebuildNameOrder(graph)) return 0;
+
+    size_t length = strlen(prefix);
+    int low = 0, high = graph->nameOrderCount;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (strcmp(graph->users[graph->nameOrder[mid]].name, prefix) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    int count = 0;
+    for (int i = low; i < graph->nameOrderCount && count < maxCount; i++) {
+        int userId = graph->nameOrder[i];
+        if (strncmp(graph->users[userId].name, prefix, length) != 0) break;
+        ids[count++] = userId;
+    }
+    return count;
+}
+// ûʾȸɾûIDûIDڴ治㷵-1
+int insertUser(Graph* graph, const char* name) {
+    if (graph->freeCount == 0 && graph->nextId >= graph->userCapacity && !growUsers(graph)) {
+        return -1;
+    }
+    if (!reserveNameIndex(&graph->nameIndex)) {
         return -1;
     }
 
-    int id = graph->nextId++;
+    int id = (graph->freeCount > 0) ? graph->freeIds[--graph->freeCount] : graph->nextId++;
     graph->users[id].id = id;
     strncpy(graph->users[id].name, name, MAX_NAME_LEN - 1);
     graph->users[id].name[MAX_NAME_LEN - 1] = '\0';  // ȷַ
     graph->users[id].exists = true;
+    graph->users[id].hasHubBitmap = false;
     graph->userCount++;
+    graph->degreeHistogram[0]++;  // ûûк
+    addToNameIndex(graph, id);
+    graph->nameOrderValid = false;
+    return id;
+}
+// ¿ճûIDڴ治㷵0
+int pushFreeId(Graph* graph, int userId) {
+    if (graph->freeCount >= graph->freeCapacity) {
+        int newCapacity = (graph->freeCapacity == 0) ? INIT_FREE_ID_CAPACITY : graph->freeCapacity * 2;
+        int* newFreeIds = (int*)realloc(graph->freeIds, newCapacity * sizeof(int));
+        if (newFreeIds == NULL) return 0;
+        graph->freeIds = newFreeIds;
+        graph->freeCapacity = newCapacity;
+    }
+    graph->freeIds[graph->freeCount++] = userId;
+    return 1;
+}
+// ļͼ֮ؽͿID1nextId-1֮䲻ڵûIDԸã
+int rebuildUserIndexes(Graph* graph) {
+    graph->nameIndex.count = 0;
+    int bits = INIT_NAME_INDEX_BITS;
+    while ((long long)graph->userCount * 4 > (3LL << bits)) bits++;
+    free(graph->nameIndex.ids);
+    free(graph->nameIndex.hashes);
+    graph->nameIndex.ids = NULL;
+    graph->nameIndex.hashes = NULL;
+    if (!resizeNameIndex(&graph->nameIndex, bits)) return 0;
+
+    graph->freeCount = 0;
+    for (int u = graph->nextId - 1; u >= 1; u--) {
+        if (graph->users[u].exists) {
+            addToNameIndex(graph, u);
+        } else if (!pushFreeId(graph, u)) {
+            return 0;
+        }
+    }
+    graph->nameOrderValid = false;
+    return 1;
+}
+// û
+int addUser(Graph* graph, const char* name) {
+    int id = insertUser(graph, name);
+    if (id < 0) {
+        printf("ڴʧܣ\n");
+        return -1;
+    }
 
     printf("û \"%s\" ӳɹûID: %d\n", name, id);
     return id;
@@ -91,10 +770,429 @@ int addUser(Graph* graph, const char* name) {
     free(graph);
     return 0;
 }*/
+// ʼûĺ
+void startFriendIterator(FriendIterator* it, const Graph* graph, int userId) {
+    it->base = graph->neighbors + graph->rowStart[userId];
+    it->baseLeft = graph->baseDegree[userId];
+    it->graph = graph;
+    it->pending = graph->pendingHead[userId];
+}
+// ȡһѵID귵-1
+int nextFriend(FriendIterator* it) {
+    if (it->baseLeft > 0) {
+        it->baseLeft--;
+        return *it->base++;
+    }
+    if (it->pending < 0) return -1;
+
+    int friendId = it->graph->pendingFriend[it->pending];
+    it->pending = it->graph->pendingNext[it->pending];
+    return friendId;
+}
+// ڿյжֲңneighborsе±꣬Ҳ-1
+int findInBaseRow(const Graph* graph, int userId, int friendId) {
+    int low = graph->rowStart[userId];
+    int high = low + graph->baseDegree[userId] - 1;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        if (graph->neighbors[mid] == friendId) return mid;
+        if (graph->neighbors[mid] < friendId) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return -1;
+}
+// ѹϵڹϣеļ˵Ⱥ˳޹أ
+unsigned long long edgeKey(int userId1, int userId2) {
+    if (userId1 > userId2) {
+        int temp = userId1;
+        userId1 = userId2;
+        userId2 = temp;
+    }
+    return ((unsigned long long)userId1 << 32) | (unsigned int)userId2;
+}
+// ʼλ˷ϣȡ˻ĸbitsλ
+int edgeSlot(const EdgeSet* set, unsigned long long key) {
+    return (int)((key * 0x9E3779B97F4A7C15ULL) >> (64 - set->bits));
+}
+// ҼڵĲλҲ-1
+int edgeSetFind(const EdgeSet* set, unsigned long long key) {
+    if (set->keys == NULL) return -1;
+
+    int mask = (1 << set->bits) - 1;
+    for (int i = edgeSlot(set, key); set->keys[i] != 0; i = (i + 1) & mask) {
+        if (set->keys[i] == key) return i;
+    }
+    return -1;
+}
+// ϣݵ 2^newBits λ·м
+int edgeSetResize(EdgeSet* set, int newBits) {
+    unsigned long long* newKeys = (unsigned long long*)calloc(1ULL << newBits,
+                                                              sizeof(unsigned long long));
+    if (newKeys == NULL) return 0;
+
+    unsigned long long* oldKeys = set->keys;
+    int oldCapacity = (oldKeys == NULL) ? 0 : (1 << set->bits);
+    set->keys = newKeys;
+    set->bits = newBits;
+
+    int mask = (1 << newBits) - 1;
+    for (int i = 0; i < oldCapacity; i++) {
+        if (oldKeys[i] == 0) continue;
+        int slot = edgeSlot(set, oldKeys[i]);
+        while (newKeys[slot] != 0) slot = (slot + 1) & mask;
+        newKeys[slot] = oldKeys[i];
+    }
+    free(oldKeys);
+    return 1;
+}
+// һѹϵɹ1Ѵڷ0ڴ治㷵-1
+int edgeSetInsert(EdgeSet* set, unsigned long long key) {
+    if (set->keys == NULL || (long long)(set->count + 1) * 4 > (3LL << set->bits)) {
+        int newBits = (set->keys == NULL) ? INIT_EDGE_SET_BITS : set->bits + 1;
+        if (!edgeSetResize(set, newBits)) return -1;
+    }
+
+    int mask = (1 << set->bits) - 1;
+    int i = edgeSlot(set, key);
+    for (; set->keys[i] != 0; i = (i + 1) & mask) {
+        if (set->keys[i] == key) return 0;
+    }
+    set->keys[i] = key;
+    set->count++;
+    return 1;
+}
+// ɾһѹϵڷ0
+int edgeSetRemove(EdgeSet* set, unsigned long long key) {
+    int hole = edgeSetFind(set, key);
+    if (hole < 0) return 0;
+
+    // Ѻ̽ϵļŲλʼλ (hole, i] ֮ļҪŲ
+    int mask = (1 << set->bits) - 1;
+    set->keys[hole] = 0;
+    for (int i = (hole + 1) & mask; set->keys[i] != 0; i = (i + 1) & mask) {
+        int home = edgeSlot(set, set->keys[i]);
+        bool reachable = (hole < i) ? (home > hole && home <= i) : (home > hole || home <= i);
+        if (reachable) continue;
+
+        set->keys[hole] = set->keys[i];
+        set->keys[i] = 0;
+        hole = i;
+    }
+    set->count--;
+    return 1;
+}
+// жûǷѾǺѣϣϣO(1)
+bool areFriends(const Graph* graph, int userId1, int userId2) {
+    return edgeSetFind(&graph->edgeSet, edgeKey(userId1, userId2)) >= 0;
+}
+// жûǷѾǺѣںбвңܶԱȣ
+bool areFriendsInRows(const Graph* graph, int userId1, int userId2) {
+    if (findInBaseRow(graph, userId1, userId2) >= 0) return true;
+
+    for (int i = graph->pendingHead[userId1]; i >= 0; i = graph->pendingNext[i]) {
+        if (graph->pendingFriend[i] == userId2) return true;
+    }
+    return false;
+}
+// ׷ӻһ¼userIdfriendId
+int appendPending(Graph* graph, int userId, int friendId) {
+    if (graph->pendingCount >= graph->pendingCapacity) {
+        int newCapacity = (graph->pendingCapacity == 0) ?
+                          INIT_PENDING_CAPACITY : graph->pendingCapacity * 2;
+        int* newFriend = (int*)realloc(graph->pendingFriend, newCapacity * sizeof(int));
+        if (newFriend == NULL) return 0;
+        graph->pendingFriend = newFriend;
+        int* newNext = (int*)realloc(graph->pendingNext, newCapacity * sizeof(int));
+        if (newNext == NULL) return 0;
+        graph->pendingNext = newNext;
+        if (graph->pendingAttr != NULL) {
+            EdgeAttr* newAttr = (EdgeAttr*)realloc(graph->pendingAttr, newCapacity * sizeof(EdgeAttr));
+            if (newAttr == NULL) return 0;
+            graph->pendingAttr = newAttr;
+        }
+        graph->pendingCapacity = newCapacity;
+    }
+
+    int index = graph->pendingCount++;
+    graph->pendingFriend[index] = friendId;
+    graph->pendingNext[index] = graph->pendingHead[userId];
+    graph->pendingHead[userId] = index;
+    graph->pendingLive++;
+    return 1;
+}
+// ׷ӻɾһ¼ڷ0
+int removePending(Graph* graph, int userId, int friendId) {
+    int prev = -1;
+    for (int i = graph->pendingHead[userId]; i >= 0; prev = i, i = graph->pendingNext[i]) {
+        if (graph->pendingFriend[i] != friendId) continue;
+
+        if (prev < 0) {
+            graph->pendingHead[userId] = graph->pendingNext[i];
+        } else {
+            graph->pendingNext[prev] = graph->pendingNext[i];
+        }
+        graph->pendingLive--;
+        return 1;
+    }
+    return 0;
+}
+// Ƚqsort
+int compareInts(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+// ûĺѰIDдoutȸƿеУٲ뻺ºѣغ
+int copySortedRow(const Graph* graph, int userId, int* out) {
+    int length = graph->baseDegree[userId];
+    if (length > 0) {
+        memcpy(out, graph->neighbors + graph->rowStart[userId], length * sizeof(int));
+    }
+    int added = 0;
+    for (int i = graph->pendingHead[userId]; i >= 0; i = graph->pendingNext[i]) {
+        out[length + added++] = graph->pendingFriend[i];
+    }
+    if (added > PENDING_INSERT_LIMIT) {
+        qsort(out, length + added, sizeof(int), compareInts);
+        return length + added;
+    }
+
+    // ºֻͨһö
+    for (int k = 0; k < added; k++) {
+        int value = out[length];
+        int j = length - 1;
+        while (j >= 0 && out[j] > value) {
+            out[j + 1] = out[j];
+            j--;
+        }
+        out[j + 1] = value;
+        length++;
+    }
+    return length;
+}
+// ϲʱеһ¼ʱºȰIDей鲢
+typedef struct {
+    int friendId;
+    int record;                  // ׷ӻе±
+} PendingEntry;
+// Ƚ¼ĺIDqsort
+int comparePendingEntries(const void* a, const void* b) {
+    int x = ((const PendingEntry*)a)->friendId, y = ((const PendingEntry*)b)->friendId;
+    return (x > y) - (x < y);
+}
+// copySortedRowͬͬʱÿѵıдoutAttrorderܷ¸ûȫº
+int copySortedRowWithAttrs(const Graph* graph, int userId, int* out, EdgeAttr* outAttr,
+                           PendingEntry* order) {
+    int added = 0;
+    for (int i = graph->pendingHead[userId]; i >= 0; i = graph->pendingNext[i]) {
+        order[added].friendId = graph->pendingFriend[i];
+        order[added].record = i;
+        added++;
+    }
+    if (added > PENDING_INSERT_LIMIT) {
+        qsort(order, added, sizeof(PendingEntry), comparePendingEntries);
+    } else {
+        for (int k = 1; k < added; k++) {
+            PendingEntry entry = order[k];
+            int j = k - 1;
+            while (j >= 0 && order[j].friendId > entry.friendId) {
+                order[j + 1] = order[j];
+                j--;
+            }
+            order[j + 1] = entry;
+        }
+    }
+
+    const int* row = graph->neighbors + graph->rowStart[userId];
+    const EdgeAttr* rowAttr = graph->neighborAttr + graph->rowStart[userId];
+    int length = graph->baseDegree[userId];
+    int i = 0, k = 0, pos = 0;
+    while (i < length || k < added) {
+        if (k == added || (i < length && row[i] < order[k].friendId)) {
+            out[pos] = row[i];
+            outAttr[pos++] = rowAttr[i++];
+        } else {
+            out[pos] = order[k].friendId;
+            outAttr[pos++] = graph->pendingAttr[order[k++].record];
+        }
+    }
+    return pos;
+}
+// ׷ӻϲCSRգ·Уÿеº루¼ʱԸźһƶ
+int mergePendingEdges(Graph* graph) {
+    if (graph->pendingCount == 0) return 1;
+
+    int total = graph->baseEdgeCount + graph->pendingLive;
+    int* newRowStart = (int*)malloc((graph->userCapacity + 1) * sizeof(int));
+    int* newNeighbors = (int*)malloc((total > 0 ? total : 1) * sizeof(int));
+    EdgeAttr* newAttr = NULL;
+    PendingEntry* order = NULL;
+    if (graph->neighborAttr != NULL) {
+        newAttr = (EdgeAttr*)malloc((total > 0 ? total : 1) * sizeof(EdgeAttr));
+        order = (PendingEntry*)malloc(graph->pendingCount * sizeof(PendingEntry));
+    }
+    if (newRowStart == NULL || newNeighbors == NULL ||
+        (graph->neighborAttr != NULL && (newAttr == NULL || order == NULL))) {
+        printf("ڴʧܣ\n");
+        free(newRowStart);
+        free(newNeighbors);
+        free(newAttr);
+        free(order);
+        return 0;
+    }
+
+    int pos = 0;
+    for (int u = 0; u < graph->userCapacity; u++) {
+        newRowStart[u] = pos;
+        int rowLength = (newAttr != NULL) ?
+                        copySortedRowWithAttrs(graph, u, newNeighbors + pos, newAttr + pos, order) :
+                        copySortedRow(graph, u, newNeighbors + pos);
+        graph->baseDegree[u] = rowLength;
+        graph->pendingHead[u] = -1;
+        pos += rowLength;
+    }
+    newRowStart[graph->userCapacity] = pos;
+
+    free(graph->rowStart);
+    free(graph->neighbors);
+    graph->rowStart = newRowStart;
+    graph->neighbors = newNeighbors;
+    if (newAttr != NULL) {
+        free(graph->neighborAttr);
+        free(order);
+        graph->neighborAttr = newAttr;
+    }
+    graph->baseEdgeCount = pos;
+    graph->pendingCount = 0;
+    graph->pendingLive = 0;
+    return 1;
+}
+// ûĺλͼѹϵ仯ã
+void dropHubBitmap(Graph* graph, int userId) {
+    if (!graph->users[userId].hasHubBitmap) return;
+
+    for (int i = 0; i < graph->hubCount; i++) {
+        if (graph->hubBitmaps[i].userId != userId) continue;
+        free(graph->hubBitmaps[i].bits);
+        graph->hubBitmaps[i] = graph->hubBitmaps[--graph->hubCount];
+        break;
+    }
+    graph->users[userId].hasHubBitmap = false;
+}
+// ûĺdelta1-1ͬʱºֲ
+void changeDegree(Graph* graph, int userId, int delta) {
+    int oldDegree = graph->degree[userId];
+    int newDegree = oldDegree + delta;
+    graph->degree[userId] = newDegree;
+    graph->degreeHistogram[oldDegree]--;
+    graph->degreeHistogram[newDegree]++;
+
+    // ÿ仯1ʱһ
+    if (newDegree > graph->maxDegree) {
+        graph->maxDegree = newDegree;
+    } else if (graph->degreeHistogram[graph->maxDegree] == 0) {
+        graph->maxDegree--;
+    }
+}
+// бͳûĺļͼ֮ã
+void recountDegrees(Graph* graph) {
+    memset(graph->degreeHistogram, 0, graph->userCapacity * sizeof(int));
+    graph->maxDegree = 0;
+    for (int u = 0; u < graph->userCapacity; u++) {
+        int count = graph->baseDegree[u];
+        for (int i = graph->pendingHead[u]; i >= 0; i = graph->pendingNext[i]) {
+            count++;
+        }
+        graph->degree[u] = count;
+        if (u > 0 && u < graph->nextId && graph->users[u].exists) {
+            graph->degreeHistogram[count]++;
+            if (count > graph->maxDegree) graph->maxDegree = count;
+        }
+    }
+}
+// ûȦĸ·룺ʱþĽڵָ游ڵ㣩
+int findCircleRoot(Graph* graph, int userId) {
+    int* parent = graph->circleParent;
+    while (parent[userId] != userId) {
+        parent[userId] = parent[parent[userId]];
+        userId = parent[userId];
+    }
+    return userId;
+}
+// ϲûڵȦٵĹҵ˶棩
+void uniteCircles(Graph* graph, int userId1, int userId2) {
+    int root1 = findCircleRoot(graph, userId1);
+    int root2 = findCircleRoot(graph, userId2);
+    if (root1 == root2) return;
+
+    if (graph->circleSize[root1] < graph->circleSize[root2]) {
+        int temp = root1;
+        root1 = root2;
+        root2 = temp;
+    }
+    graph->circleParent[root2] = root1;
+    graph->circleSize[root1] += graph->circleSize[root2];
+}
+// ǰĺѹϵؽȦ鼯ɾ֮Ҫ
+void rebuildCircles(Graph* graph) {
+    for (int u = 0; u < graph->userCapacity; u++) {
+        graph->circleParent[u] = u;
+        graph->circleSize[u] = 1;
+    }
+    for (int u = 1; u < graph->nextId; u++) {
+        FriendIterator it;
+        startFriendIterator(&it, graph, u);
+        for (int friendId = nextFriend(&it); friendId >= 0; friendId = nextFriend(&it)) {
+            if (friendId > u) uniteCircles(graph, u, friendId);  // ÿѹϵֻϲһ
+        }
+    }
+    graph->circlesValid = true;
+}
+// ѹϵʾɹ1ѾǺѷ0ڴ治㷵-1
+int insertFriendship(Graph* graph, int userId1, int userId2) {
+    unsigned long long key = edgeKey(userId1, userId2);
+    int result = edgeSetInsert(&graph->edgeSet, key);
+    if (result <= 0) {
+        return result;
+    }
+    dropHubBitmap(graph, userId1);
+    dropHubBitmap(graph, userId2);
+
+    // ׷ʧʱعѾļ¼
+    if (!appendPending(graph, userId1, userId2)) {
+        edgeSetRemove(&graph->edgeSet, key);
+        return -1;
+    }
+    if (!appendPending(graph, userId2, userId1)) {
+        removePending(graph, userId1, userId2);
+        edgeSetRemove(&graph->edgeSet, key);
+        return -1;
+    }
+    if (graph->pendingAttr != NULL) {
+        // ¼ռڻĩβ
+        EdgeAttr attr = {DEFAULT_FRIEND_WEIGHT, 0, (long long)time(NULL)};
+        graph->pendingAttr[graph->pendingCount - 2] = attr;
+        graph->pendingAttr[graph->pendingCount - 1] = attr;
+    }
+
+    // յ1/8ʱϲϲĴ۷̯ÿμӺǳ
+    if (graph->pendingLive >= MIN_PENDING_MERGE &&
+        graph->pendingLive * 8 >= graph->baseEdgeCount) {
+        mergePendingEdges(graph);
+    }
+    changeDegree(graph, userId1, 1);
+    changeDegree(graph, userId2, 1);
+    if (graph->circlesValid) {
+        uniteCircles(graph, userId1, userId2);
+    }
+    return 1;
+}
 // Ӻѹϵͼ˫ӣ
 int addFriend(Graph* graph, int userId1, int userId2) {
     // ûǷ
-    if (!graph->users[userId1].exists || !graph->users[userId2].exists) {
+    if (!isValidUser(graph, userId1) || !isValidUser(graph, userId2)) {
         printf("ûڣ\n");
         return 0;
     }
@@ -105,32 +1203,15 @@ int addFriend(Graph* graph, int userId1, int userId2) {
         return 0;
     }
 
-    // ǷѾǺ
-    AdjListNode* current = graph->adjLists[userId1].head;
-    while (current != NULL) {
-        if (current->userId == userId2) {
-            printf("û %d û %d ѾǺѣ\n", userId1, userId2);
-            return 0;
-        }
-        current = current->next;
+    int result = insertFriendship(graph, userId1, userId2);
+    if (result == 0) {
+        printf("û %d û %d ѾǺѣ\n", userId1, userId2);
+        return 0;
     }
-
-    //  userId2  userId1 ڽӱͷ巨
-    AdjListNode* node1 = createAdjListNode(userId2);
-    if (node1 == NULL) return 0;
-    node1->next = graph->adjLists[userId1].head;
-    graph->adjLists[userId1].head = node1;
-
-    //  userId1  userId2 ڽӱͼ˫
-    AdjListNode* node2 = createAdjListNode(userId1);
-    if (node2 == NULL) {
-        // ڶڵ㴴ʧܣҪعһڵ
-        graph->adjLists[userId1].head = node1->next;
-        free(node1);
+    if (result < 0) {
+        printf("ڴʧܣ\n");
         return 0;
     }
-    node2->next = graph->adjLists[userId2].head;
-    graph->adjLists[userId2].head = node2;
 
     printf("ѹϵӳɹû %d û %d Ǻѡ\n", userId1, userId2);
     return 1;
@@ -143,45 +1224,116 @@ int addFriend(Graph* graph, int userId1, int userId2) {
     addFriend(graph, 1, 2);
     return 0;
 }*/
-// ɾѹϵ
-int removeFriend(Graph* graph, int userId1, int userId2) {
-    if (!graph->users[userId1].exists || !graph->users[userId2].exists) {
-        printf("ûڣ\n");
-        return 0;
+// userIdĺȥfriendIdںԪǰƣ򣩣ڷ0
+int removeFriendEntry(Graph* graph, int userId, int friendId) {
+    int index = findInBaseRow(graph, userId, friendId);
+    if (index < 0) {
+        return removePending(graph, userId, friendId);
     }
 
-    //  userId1 ڽӱɾ userId2
-    AdjListNode* prev = NULL;
-    AdjListNode* current = graph->adjLists[userId1].head;
-    while (current != NULL && current->userId != userId2) {
-        prev = current;
-        current = current->next;
+    int rowEnd = graph->rowStart[userId] + graph->baseDegree[userId];
+    memmove(graph->neighbors + index, graph->neighbors + index + 1,
+            (rowEnd - index - 1) * sizeof(int));
+    if (graph->neighborAttr != NULL) {
+        memmove(graph->neighborAttr + index, graph->neighborAttr + index + 1,
+                (rowEnd - index - 1) * sizeof(EdgeAttr));
+    }
+    graph->baseDegree[userId]--;
+    graph->baseEdgeCount--;
+    return 1;
+}
+// ҺfriendIduserIdеıԣǺѻûм¼ԷNULL
+EdgeAttr* findEdgeAttr(Graph* graph, int userId, int friendId) {
+    if (graph->neighborAttr == NULL) return NULL;
+
+    int index = findInBaseRow(graph, userId, friendId);
+    if (index >= 0) return &graph->neighborAttr[index];
+    for (int i = graph->pendingHead[userId]; i >= 0; i = graph->pendingNext[i]) {
+        if (graph->pendingFriend[i] == friendId) return &graph->pendingAttr[i];
     }
-    if (current != NULL) {
-        if (prev == NULL) {
-            // ɾͷڵ
-            graph->adjLists[userId1].head = current->next;
+    return NULL;
+}
+// жϻinteractionsεĺfriendIdǷӦtieǰ棨ǰIDСǰ
+bool strongerTie(int friendId, int interactions, const StrongTie* tie) {
+    if (interactions != tie->interactions) return interactions > tie->interactions;
+    return friendId < tie->friendId;
+}
+// friendIdĻӵinteractionsuserIdܺ
+// ֻúֻǰŲ߼һO(STRONG_TIE_COUNT)
+void raiseStrongTie(Graph* graph, int userId, int friendId, int interactions) {
+    StrongTie* ties = graph->strongTies + (long long)userId * STRONG_TIE_COUNT;
+    int count = graph->strongTieCount[userId];
+    int i = 0;
+    while (i < count && ties[i].friendId != friendId) i++;
+    if (i == count) {
+        if (count < STRONG_TIE_COUNT) {
+            graph->strongTieCount[userId] = count + 1;
+        } else if (strongerTie(friendId, interactions, &ties[count - 1])) {
+            i = count - 1;
         } else {
-            // ɾмβڵ
-            prev->next = current->next;
+            return;
         }
-        free(current);
     }
 
-    //  userId2 ڽӱɾ userId1ͼ˫ɾ
-    prev = NULL;
-    current = graph->adjLists[userId2].head;
-    while (current != NULL && current->userId != userId1) {
-        prev = current;
-        current = current->next;
+    while (i > 0 && strongerTie(friendId, interactions, &ties[i - 1])) {
+        ties[i] = ties[i - 1];
+        i--;
     }
-    if (current != NULL) {
-        if (prev == NULL) {
-            graph->adjLists[userId2].head = current->next;
-        } else {
-            prev->next = current->next;
+    ties[i].friendId = friendId;
+    ties[i].interactions = interactions;
+}
+// ɨУѡuserIdܺ
+void rebuildStrongTies(Graph* graph, int userId) {
+    graph->strongTieCount[userId] = 0;
+    const int* row = graph->neighbors + graph->rowStart[userId];
+    const EdgeAttr* rowAttr = graph->neighborAttr + graph->rowStart[userId];
+    for (int i = 0; i < graph->baseDegree[userId]; i++) {
+        if (rowAttr[i].interactions > 0) raiseStrongTie(graph, userId, row[i], rowAttr[i].interactions);
+    }
+    for (int i = graph->pendingHead[userId]; i >= 0; i = graph->pendingNext[i]) {
+        if (graph->pendingAttr[i].interactions > 0) {
+            raiseStrongTie(graph, userId, graph->pendingFriend[i], graph->pendingAttr[i].interactions);
+        }
+    }
+}
+// ˲ǺѺãfriendIduserIdܺʱճλҪɨѡ
+void dropStrongTie(Graph* graph, int userId, int friendId) {
+    if (graph->strongTies == NULL) return;
+
+    const StrongTie* ties = graph->strongTies + (long long)userId * STRONG_TIE_COUNT;
+    for (int i = 0; i < graph->strongTieCount[userId]; i++) {
+        if (ties[i].friendId == friendId) {
+            rebuildStrongTies(graph, userId);
+            return;
         }
-        free(current);
+    }
+}
+// ɾѹϵʾɹ1Ǻѷ0
+int deleteFriendship(Graph* graph, int userId1, int userId2) {
+    if (!edgeSetRemove(&graph->edgeSet, edgeKey(userId1, userId2))) {
+        return 0;
+    }
+    removeFriendEntry(graph, userId1, userId2);
+    removeFriendEntry(graph, userId2, userId1);  // ͼ˫ɾ
+    dropStrongTie(graph, userId1, userId2);
+    dropStrongTie(graph, userId2, userId1);
+    dropHubBitmap(graph, userId1);
+    dropHubBitmap(graph, userId2);
+    changeDegree(graph, userId1, -1);
+    changeDegree(graph, userId2, -1);
+    graph->circlesValid = false;  // Ȧܱ
+    return 1;
+}
+// ɾѹϵ
+int removeFriend(Graph* graph, int userId1, int userId2) {
+    if (!isValidUser(graph, userId1) || !isValidUser(graph, userId2)) {
+        printf("ûڣ\n");
+        return 0;
+    }
+
+    if (!deleteFriendship(graph, userId1, userId2)) {
+        printf("û %d û %d Ǻѣ\n", userId1, userId2);
+        return 0;
     }
 
     printf("ѹϵɾɹ\n");
@@ -190,285 +1342,3915 @@ int removeFriend(Graph* graph, int userId1, int userId2) {
 // ȡûк
 void getFriends(Graph* graph, int userId, int* friends, int* count) {
     *count = 0;
-    AdjListNode* current = graph->adjLists[userId].head;
-    while (current != NULL) {
-        friends[(*count)++] = current->userId;
-        current = current->next;
+    FriendIterator it;
+    startFriendIterator(&it, graph, userId);
+    for (int friendId = nextFriend(&it); friendId >= 0; friendId = nextFriend(&it)) {
+        friends[(*count)++] = friendId;
     }
 }
-// BFS·Ⱥѣ
-int findShortestPath(Graph* graph, int fromUserId, int toUserId,
+// ͳûĺ
+int getFriendCount(const Graph* graph, int userId) {
+    return graph->degree[userId];
+}
+// ɾûʾɾûкѹϵٿճIDԺӵû
+// ÿֻԼĺбȥûܴȣûڷ0
+int deleteUser(Graph* graph, int userId) {
+    if (!isValidUser(graph, userId)) return 0;
+    if (!pushFreeId(graph, userId)) return -1;  // ռλã治ʧ
+
+    FriendIterator it;
+    startFriendIterator(&it, graph, userId);
+    for (int friendId = nextFriend(&it); friendId >= 0; friendId = nextFriend(&it)) {
+        edgeSetRemove(&graph->edgeSet, edgeKey(userId, friendId));
+        removeFriendEntry(graph, friendId, userId);
+        dropStrongTie(graph, friendId, userId);
+        dropHubBitmap(graph, friendId);
+        changeDegree(graph, friendId, -1);
+        changeDegree(graph, userId, -1);
+    }
+
+    // ûԼĺб
+    graph->baseEdgeCount -= graph->baseDegree[userId];
+    graph->baseDegree[userId] = 0;
+    for (int i = graph->pendingHead[userId]; i >= 0; i = graph->pendingNext[i]) {
+        graph->pendingLive--;
+    }
+    graph->pendingHead[userId] = -1;
+    if (graph->strongTieCount != NULL) graph->strongTieCount[userId] = 0;
+    dropHubBitmap(graph, userId);
+
+    removeFromNameIndex(graph, userId);
+    graph->nameOrderValid = false;
+    graph->circlesValid = false;
+    graph->degreeHistogram[0]--;
+    graph->users[userId].exists = false;
+    graph->userCount--;
+    return 1;
+}
+// ɾû
+int removeUser(Graph* graph, int userId) {
+    int friendCount = isValidUser(graph, userId) ? getFriendCount(graph, userId) : 0;
+    int result = deleteUser(graph, userId);
+    if (result == 0) {
+        printf("ûڣ\n");
+        return 0;
+    }
+    if (result < 0) {
+        printf("ڴʧܣ\n");
+        return 0;
+    }
+
+    printf("û %d ɾͬʱɾ %d ѹϵ\n", userId, friendCount);
+    return 1;
+}
+// ¼֮timesλʾ˫еĻһӣ˫ܺ
+// ͼûм¼ʱȿʼ¼ɹ1Ǻѷ0ڴ治㷵-1
+int recordInteraction(Graph* graph, int userId1, int userId2, int times) {
+    if (times <= 0 || !areFriends(graph, userId1, userId2)) return 0;
+    if (!enableEdgeAttributes(graph)) return -1;
+
+    EdgeAttr* attr1 = findEdgeAttr(graph, userId1, userId2);
+    EdgeAttr* attr2 = findEdgeAttr(graph, userId2, userId1);
+    int interactions = (attr1->interactions > INT_MAX - times) ? INT_MAX : attr1->interactions + times;
+    attr1->interactions = interactions;
+    attr2->interactions = interactions;
+    raiseStrongTie(graph, userId1, userId2, interactions);
+    raiseStrongTie(graph, userId2, userId1, interactions);
+    return 1;
+}
+// úѹϵȨأʾɹ1ǺѻȨز0ڴ治㷵-1
+int setFriendshipWeight(Graph* graph, int userId1, int userId2, int weight) {
+    if (weight <= 0 || !areFriends(graph, userId1, userId2)) return 0;
+    if (!enableEdgeAttributes(graph)) return -1;
+
+    findEdgeAttr(graph, userId1, userId2)->weight = weight;
+    findEdgeAttr(graph, userId2, userId1)->weight = weight;
+    return 1;
+}
+// жϺѹϵǷڲbefore֮ǰΪѣminInteractionsΪѵʱδ֪Ĳ㣩
+bool isStaleTie(const EdgeAttr* attr, long long before, int minInteractions) {
+    return attr->createdAt > 0 && attr->createdAt < before && attr->interactions < minInteractions;
+}
+// ɾгڲĺѹϵɾڴ治㷵-1
+// ȰҪɾĺѹϵռɾһ߱һ޸
+int expireStaleFriendships(Graph* graph, long long before, int minInteractions) {
+    if (graph->neighborAttr == NULL) return 0;
+
+    int* stale = (int*)malloc((graph->edgeSet.count > 0 ? graph->edgeSet.count : 1) * 2 * sizeof(int));
+    if (stale == NULL) return -1;
+
+    int count = 0;
+    for (int u = 1; u < graph->nextId; u++) {
+        const int* row = graph->neighbors + graph->rowStart[u];
+        const EdgeAttr* rowAttr = graph->neighborAttr + graph->rowStart[u];
+        for (int i = 0; i < graph->baseDegree[u]; i++) {
+            if (row[i] > u && isStaleTie(&rowAttr[i], before, minInteractions)) {
+                stale[2 * count] = u;
+                stale[2 * count + 1] = row[i];
+                count++;
+            }
+        }
+        for (int i = graph->pendingHead[u]; i >= 0; i = graph->pendingNext[i]) {
+            if (graph->pendingFriend[i] > u && isStaleTie(&graph->pendingAttr[i], before, minInteractions)) {
+                stale[2 * count] = u;
+                stale[2 * count + 1] = graph->pendingFriend[i];
+                count++;
+            }
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        deleteFriendship(graph, stale[2 * i], stale[2 * i + 1]);
+    }
+    free(stale);
+    return count;
+}
+// ƲûʾʾͬûʾԴ˿ͷû
+void displayUsersByName(Graph* graph, const char* name) {
+    int ids[NAME_SEARCH_LIMIT];
+    int count = findUsersByName(graph, name, ids, NAME_SEARCH_LIMIT);
+    printf("\nΪ \"%s\" û", name);
+    if (count == 0) printf("");
+    printf("\n");
+    for (int i = 0; i < count; i++) {
+        printf("  - û %d: %s %d \n", ids[i], graph->users[ids[i]].name,
+               getFriendCount(graph, ids[i]));
+    }
+
+    count = findUsersByPrefix(graph, name, ids, NAME_SEARCH_LIMIT);
+    printf(" \"%s\" ͷûʾ %d ", name, NAME_SEARCH_LIMIT);
+    if (count == 0) printf("");
+    printf("\n");
+    for (int i = 0; i < count; i++) {
+        printf("  - û %d: %s\n", ids[i], graph->users[ids[i]].name);
+    }
+    printf("\n");
+}
+// BFS·Ⱥѣ
+int findShortestPath(Graph* graph, int fromUserId, int toUserId,
                      int* path, int* pathLength) {
-    if (!graph->users[fromUserId].exists || !graph->users[toUserId].exists) {
+    if (!isValidUser(graph, fromUserId) || !isValidUser(graph, toUserId)) {
+        return -1;  // û
+    }
+
+    if (fromUserId == toUserId) {
+        path[0] = fromUserId;
+        *pathLength = 1;
+        return 0;  // 0ȣԼ
+    }
+
+    // BFSе鸴̵߳ʱ飬ûʼ
+    SearchScratch* scratch = getSearchScratch(graph);
+    if (scratch == NULL) {
+        printf("ڴʧܣ\n");
+        return -1;
+    }
+    beginVisit(scratch);
+    int* queue = scratch->queue;
+    int* parent = scratch->parent;
+    int front = 0, rear = 0;
+
+    // ʼڵ㿪ʼBFS
+    queue[rear++] = fromUserId;
+    scratch->visitMark[fromUserId] = scratch->epoch;
+    parent[fromUserId] = -1;
+
+    while (front < rear) {
+        int current = queue[front++];
+
+        // ҵĿڵ
+        if (current == toUserId) {
+            scratch->visitedCount = rear;
+            // ·
+            *pathLength = 0;
+            int node = toUserId;
+            while (node != -1) {
+                path[(*pathLength)++] = node;
+                node = parent[node];
+            }
+
+            // ת·ΪǴĿݵ㣩
+            for (int i = 0; i < *pathLength / 2; i++) {
+                int temp = path[i];
+                path[i] = path[*pathLength - 1 - i];
+                path[*pathLength - 1 - i] = temp;
+            }
+
+            return *pathLength - 1;
+        }
+
+        // ڽӽڵ
+        FriendIterator it;
+        startFriendIterator(&it, graph, current);
+        for (int neighbor = nextFriend(&it); neighbor >= 0; neighbor = nextFriend(&it)) {
+            if (scratch->visitMark[neighbor] != scratch->epoch) {
+                scratch->visitMark[neighbor] = scratch->epoch;
+                queue[rear++] = neighbor;
+                parent[neighbor] = current;
+            }
+        }
+    }
+
+    scratch->visitedCount = rear;
+    return -1;  // ɴ
+}
+// ˫BFSչһ㣺queue[*front, *rear)·ʵû׷ӵβ
+// һѷʵûʱı(*meetFrom -> *meetTo)1û0
+int expandLayer(const Graph* graph, unsigned int epoch, int* queue, int* front, int* rear,
+                unsigned int* mark, int* parent, const unsigned int* otherMark,
+                int* meetFrom, int* meetTo) {
+    int layerEnd = *rear;
+    while (*front < layerEnd) {
+        int current = queue[(*front)++];
+
+        FriendIterator it;
+        startFriendIterator(&it, graph, current);
+        for (int neighbor = nextFriend(&it); neighbor >= 0; neighbor = nextFriend(&it)) {
+            if (otherMark[neighbor] == epoch) {
+                *meetFrom = current;
+                *meetTo = neighbor;
+                return 1;
+            }
+            if (mark[neighbor] != epoch) {
+                mark[neighbor] = epoch;
+                parent[neighbor] = current;
+                queue[(*rear)++] = neighbor;
+            }
+        }
+    }
+    return 0;
+}
+// ˫BFS·ͬʱÿչСһ࣬м
+// ·ʽfindShortestPathͬmaxHops > 0 ʱֻҲmaxHopsȵ·
+// ඼չԵһʱ·Ⱦ  + 1 + յ
+int findShortestPathBidirectional(Graph* graph, int fromUserId, int toUserId,
+                                  int* path, int* pathLength, int maxHops) {
+    if (!isValidUser(graph, fromUserId) || !isValidUser(graph, toUserId)) {
+        return -1;  // û
+    }
+
+    if (fromUserId == toUserId) {
+        path[0] = fromUserId;
+        *pathLength = 1;
+        return 0;  // 0ȣԼ
+    }
+
+    SearchScratch* scratch = getSearchScratch(graph);
+    if (scratch == NULL) {
+        printf("ڴʧܣ\n");
+        return -1;
+    }
+    beginVisit(scratch);
+    unsigned int epoch = scratch->epoch;
+
+    int forwardFront = 0, forwardRear = 0, forwardDepth = 0;
+    int backFront = 0, backRear = 0, backDepth = 0;
+    scratch->queue[forwardRear++] = fromUserId;
+    scratch->visitMark[fromUserId] = epoch;
+    scratch->parent[fromUserId] = -1;
+    scratch->backQueue[backRear++] = toUserId;
+    scratch->backMark[toUserId] = epoch;
+    scratch->backParent[toUserId] = -1;
+
+    int meetFrom = -1, meetTo = -1;
+    int fromForward = 1;  // ıǷһ෢
+    while (forwardFront < forwardRear && backFront < backRear) {
+        if (maxHops > 0 && forwardDepth + backDepth + 1 > maxHops) break;
+
+        // չǰСһ
+        if (forwardRear - forwardFront <= backRear - backFront) {
+            fromForward = 1;
+            if (expandLayer(graph, epoch, scratch->queue, &forwardFront, &forwardRear,
+                            scratch->visitMark, scratch->parent, scratch->backMark,
+                            &meetFrom, &meetTo)) break;
+            forwardDepth++;
+        } else {
+            fromForward = 0;
+            if (expandLayer(graph, epoch, scratch->backQueue, &backFront, &backRear,
+                            scratch->backMark, scratch->backParent, scratch->visitMark,
+                            &meetFrom, &meetTo)) break;
+            backDepth++;
+        }
+    }
+    scratch->visitedCount = forwardRear + backRear;
+    if (meetFrom < 0) return -1;  // ɴ򳬹
+
+    // ˣforwardEndһ࣬backEndյһ
+    int forwardEnd = fromForward ? meetFrom : meetTo;
+    int backEnd = fromForward ? meetTo : meetFrom;
+
+    // һࣺforwardEndݵת
+    *pathLength = 0;
+    for (int node = forwardEnd; node != -1; node = scratch->parent[node]) {
+        path[(*pathLength)++] = node;
+    }
+    for (int i = 0; i < *pathLength / 2; i++) {
+        int temp = path[i];
+        path[i] = path[*pathLength - 1 - i];
+        path[*pathLength - 1 - i] = temp;
+    }
+
+    // յһࣺbackParentָյ㷽
+    for (int node = backEnd; node != -1; node = scratch->backParent[node]) {
+        path[(*pathLength)++] = node;
+    }
+
+    return *pathLength - 1;
+}
+// Ƚlong longqsort
+int compareLongLongs(const void* a, const void* b) {
+    long long x = *(const long long*)a, y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+// ԴBFSͬʱ64seen[v]ĵiλʾiѾv
+// һηvĺѾͰһһƽorder[first..last)ǰźĲѯ
+// 32λ㣬32λǲѯ±꣩ͬһĲѯͬһλ
+// seenvisitnextȲСnextIdvisitnextǰȫΪ0ʱȫΪ0
+void runMultiSourceBfs(const Graph* graph, const long long* order, int first, int last,
+                       PathQuery* queries, unsigned long long* seen,
+                       unsigned long long* visit, unsigned long long* next,
+                       int* frontier, int* nextFrontier) {
+    memset(seen, 0, graph->nextId * sizeof(unsigned long long));
+
+    int frontierCount = 0;
+    int bit = -1;
+    for (int i = first; i < last; i++) {
+        int source = (int)(order[i] >> 32);
+        if (i == first || source != (int)(order[i - 1] >> 32)) {
+            bit++;
+            if (visit[source] == 0) frontier[frontierCount++] = source;
+            visit[source] |= 1ULL << bit;
+            seen[source] |= 1ULL << bit;
+        }
+    }
+
+    int remaining = last - first;
+    for (int level = 1; frontierCount > 0 && remaining > 0; level++) {
+        int nextCount = 0;
+        for (int i = 0; i < frontierCount; i++) {
+            int current = frontier[i];
+            unsigned long long bits = visit[current];
+            FriendIterator it;
+            startFriendIterator(&it, graph, current);
+            for (int friendId = nextFriend(&it); friendId >= 0; friendId = nextFriend(&it)) {
+                unsigned long long reached = bits & ~seen[friendId];
+                if (reached == 0) continue;
+                if (next[friendId] == 0) nextFrontier[nextCount++] = friendId;
+                next[friendId] |= reached;
+                seen[friendId] |= reached;
+            }
+        }
+        for (int i = 0; i < frontierCount; i++) {
+            visit[frontier[i]] = 0;
+        }
+
+        unsigned long long* tempBits = visit;
+        visit = next;
+        next = tempBits;
+        int* tempFrontier = frontier;
+        frontier = nextFrontier;
+        nextFrontier = tempFrontier;
+        frontierCount = nextCount;
+
+        // һ㵽յĲѯõ
+        bit = -1;
+        for (int i = first; i < last; i++) {
+            if (i == first || (order[i] >> 32) != (order[i - 1] >> 32)) bit++;
+            PathQuery* query = &queries[(int)(order[i] & 0xFFFFFFFF)];
+            if (query->distance < 0 && (seen[query->to] >> bit & 1)) {
+                query->distance = level;
+                remaining--;
+            }
+        }
+    }
+
+    // ǰʱʣһı
+    for (int i = 0; i < frontierCount; i++) {
+        visit[frontier[i]] = 0;
+    }
+}
+// ѯ·Ķ飬ÿ64ͬһζԴBFS
+// ֮以Ӱ죬ʱ -fopenmp ̲߳Удÿѯdistance
+// ڴ治㷵0
+int findShortestDistancesBatch(const Graph* graph, PathQuery* queries, int queryCount) {
+    long long* order = (long long*)malloc((queryCount > 0 ? queryCount : 1) * sizeof(long long));
+    int* batchStart = (int*)malloc((queryCount + 1) * sizeof(int));
+    if (order == NULL || batchStart == NULL) {
+        free(order);
+        free(batchStart);
+        return 0;
+    }
+
+    // ԼԼ0ȣûڵֱ-1İ
+    int orderCount = 0;
+    for (int i = 0; i < queryCount; i++) {
+        queries[i].distance = -1;
+        if (!isValidUser(graph, queries[i].from) || !isValidUser(graph, queries[i].to)) continue;
+        if (queries[i].from == queries[i].to) {
+            queries[i].distance = 0;
+            continue;
+        }
+        order[orderCount++] = ((long long)queries[i].from << 32) | i;
+    }
+    qsort(order, orderCount, sizeof(long long), compareLongLongs);
+
+    // ÿMULTI_SOURCE_BATCHͬ
+    int batchCount = 0, sourcesInBatch = 0;
+    for (int i = 0; i < orderCount; i++) {
+        if (i > 0 && (order[i] >> 32) == (order[i - 1] >> 32)) continue;
+        if (sourcesInBatch == 0 || sourcesInBatch == MULTI_SOURCE_BATCH) {
+            batchStart[batchCount++] = i;
+            sourcesInBatch = 0;
+        }
+        sourcesInBatch++;
+    }
+    batchStart[batchCount] = orderCount;
+
+    int failed = 0;
+#ifdef _OPENMP
+    #pragma omp parallel
+#endif
+    {
+        // ÿ߳һBFS飬ֵĸѯ
+        int userLimit = graph->nextId;
+        unsigned long long* seen = (unsigned long long*)malloc(userLimit * sizeof(unsigned long long));
+        unsigned long long* visit = (unsigned long long*)calloc(userLimit, sizeof(unsigned long long));
+        unsigned long long* next = (unsigned long long*)calloc(userLimit, sizeof(unsigned long long));
+        int* frontier = (int*)malloc(userLimit * sizeof(int));
+        int* nextFrontier = (int*)malloc(userLimit * sizeof(int));
+        bool ready = seen != NULL && visit != NULL && next != NULL &&
+                     frontier != NULL && nextFrontier != NULL;
+        if (!ready) failed = 1;
+
+#ifdef _OPENMP
+        #pragma omp for schedule(dynamic, 1)
+#endif
+        for (int b = 0; b < batchCount; b++) {
+            if (!ready) continue;
+            runMultiSourceBfs(graph, order, batchStart[b], batchStart[b + 1], queries,
+                              seen, visit, next, frontier, nextFrontier);
+        }
+
+        free(seen);
+        free(visit);
+        free(next);
+        free(frontier);
+        free(nextFrontier);
+    }
+
+    free(order);
+    free(batchStart);
+    return !failed;
+}
+// չNڵĺѣÿҵһûvisitorvisitorfalseѱmaxResultsʱ-1ʾޣ
+// ҪĺѼ¼δûĶʱܲ㣩ΪԵϣδʵû
+// Ƿкڵǰ㣨λͼжϣҵһͣչǰÿѼ¼
+// allowBottomUpΪfalseʱʼԶ£ܶԱȣرû
+int expandNeighborhood(Graph* graph, int userId, int maxHops, int maxResults,
+                       NeighborhoodVisitor visitor, void* context, bool allowBottomUp) {
+    if (!isValidUser(graph, userId) || maxHops <= 0) return 0;
+
+    SearchScratch* scratch = getSearchScratch(graph);
+    if (scratch == NULL) return 0;
+    beginVisit(scratch);
+    unsigned int epoch = scratch->epoch;
+    int userLimit = graph->nextId;
+
+    // δqueueУǰ [layerStart, layerEnd)
+    int* queue = scratch->queue;
+    queue[0] = userId;
+    scratch->visitMark[userId] = epoch;
+    int layerStart = 0, layerEnd = 1, reported = 0;
+    long long frontierEdges = graph->degree[userId];
+    long long unexploredEdges = 2LL * graph->edgeSet.count - frontierEdges;
+    bool bottomUp = false;
+
+    for (int hop = 1; hop <= maxHops && layerStart < layerEnd; hop++) {
+        if (!bottomUp) {
+            bottomUp = allowBottomUp && frontierEdges * BOTTOM_UP_ALPHA > unexploredEdges;
+        } else {
+            bottomUp = (long long)(layerEnd - layerStart) * BOTTOM_UP_BETA >= userLimit;
+        }
+
+        int next = layerEnd;
+        frontierEdges = 0;
+        if (!bottomUp) {
+            for (int i = layerStart; i < layerEnd; i++) {
+                FriendIterator it;
+                startFriendIterator(&it, graph, queue[i]);
+                for (int v = nextFriend(&it); v >= 0; v = nextFriend(&it)) {
+                    if (scratch->visitMark[v] == epoch) continue;
+                    scratch->visitMark[v] = epoch;
+                    queue[next++] = v;
+                    frontierEdges += graph->degree[v];
+                    reported++;
+                    if (!visitor(v, hop, context) || reported == maxResults) return reported;
+                }
+            }
+        } else {
+            unsigned long long* bits = scratch->frontierBits;
+            memset(bits, 0, ((userLimit + 63) / 64) * sizeof(unsigned long long));
+            for (int i = layerStart; i < layerEnd; i++) {
+                bits[queue[i] >> 6] |= 1ULL << (queue[i] & 63);
+            }
+            for (int v = 1; v < userLimit; v++) {
+                if (scratch->visitMark[v] == epoch || graph->degree[v] == 0) continue;
+                FriendIterator it;
+                startFriendIterator(&it, graph, v);
+                for (int u = nextFriend(&it); u >= 0; u = nextFriend(&it)) {
+                    if (!(bits[u >> 6] & (1ULL << (u & 63)))) continue;
+                    scratch->visitMark[v] = epoch;
+                    queue[next++] = v;
+                    frontierEdges += graph->degree[v];
+                    reported++;
+                    if (!visitor(v, hop, context) || reported == maxResults) return reported;
+                    break;
+                }
+            }
+        }
+        unexploredEdges -= frontierEdges;
+        layerStart = layerEnd;
+        layerEnd = next;
+    }
+    return reported;
+}
+// NڵĺѣɽԶvisitormaxResults <= 0 ʾ
+int streamKHopNeighborhood(Graph* graph, int userId, int maxHops, int maxResults,
+                           NeighborhoodVisitor visitor, void* context) {
+    if (maxResults <= 0) maxResults = -1;
+    return expandNeighborhood(graph, userId, maxHops, maxResults, visitor, context, true);
+}
+// ʾNڵĺʱĻص
+typedef struct {
+    Graph* graph;
+    int lastDistance;
+} NeighborhoodPrinter;
+
+bool printNeighbor(int userId, int distance, void* context) {
+    NeighborhoodPrinter* printer = (NeighborhoodPrinter*)context;
+    if (distance != printer->lastDistance) {
+        printf("%dȺѣ\n", distance);
+        printer->lastDistance = distance;
+    }
+    printf("  - û %d: %s\n", userId, printer->graph->users[userId].name);
+    return true;
+}
+// ʾNڵĺѣʾNEIGHBORHOOD_DISPLAY_LIMITˣ
+void displayNeighborhood(Graph* graph, int userId, int maxHops) {
+    if (!isValidUser(graph, userId)) {
+        printf("ûڣ\n");
+        return;
+    }
+    if (maxHops <= 0) {
+        printf("0\n");
+        return;
+    }
+
+    printf("\nû %s %dںѣʾ %d ˣ\n",
+           graph->users[userId].name, maxHops, NEIGHBORHOOD_DISPLAY_LIMIT);
+    NeighborhoodPrinter printer = {graph, 0};
+    int count = streamKHopNeighborhood(graph, userId, maxHops, NEIGHBORHOOD_DISPLAY_LIMIT,
+                                       printNeighbor, &printer);
+    if (count == 0) printf("  \n");
+    printf("\n");
+}
+// еһ
+typedef struct {
+    unsigned long long key;
+    int userId;
+} RadixItem;
+
+// ѣȡļʱʹõȶУDijkstraÿȡľ벻һС
+// ϴȡļlastͬķ0ͰߵĲͬλǵiλķi + 1Ͱ0Ͱȡպ
+// ѵһǿյͰСļ·ֵ͵Ͱÿ౻ƶ64ΣҪȽϴСĶѲ
+typedef struct {
+    RadixItem* items[RADIX_HEAP_BUCKETS];
+    int count[RADIX_HEAP_BUCKETS];
+    int capacity[RADIX_HEAP_BUCKETS];
+    unsigned long long last;
+    long long size;
+} RadixHeap;
+
+// ӦͰ
+int radixBucket(unsigned long long key, unsigned long long last) {
+    unsigned long long diff = key ^ last;
+    int bucket = 0;
+    for (int shift = 32; shift > 0; shift >>= 1) {
+        if ((diff >> shift) != 0) {
+            diff >>= shift;
+            bucket += shift;
+        }
+    }
+    return bucket + (int)diff;  // diffΪ0ʱ0Ͱλǵbucketλ
+}
+// һָͰڴ治㷵0
+int radixAppend(RadixHeap* heap, int bucket, RadixItem item) {
+    if (heap->count[bucket] >= heap->capacity[bucket]) {
+        int newCapacity = (heap->capacity[bucket] == 0) ?
+                          INIT_RADIX_BUCKET_CAPACITY : heap->capacity[bucket] * 2;
+        RadixItem* newItems = (RadixItem*)realloc(heap->items[bucket], newCapacity * sizeof(RadixItem));
+        if (newItems == NULL) return 0;
+        heap->items[bucket] = newItems;
+        heap->capacity[bucket] = newCapacity;
+    }
+    heap->items[bucket][heap->count[bucket]++] = item;
+    return 1;
+}
+// һkeyСϴȡļڴ治㷵0
+int radixPush(RadixHeap* heap, unsigned long long key, int userId) {
+    RadixItem item = {key, userId};
+    if (!radixAppend(heap, radixBucket(key, heap->last), item)) return 0;
+    heap->size++;
+    return 1;
+}
+// ȡСһûIDд*keyΪջڴ治㷵-1
+int radixPop(RadixHeap* heap, unsigned long long* key) {
+    if (heap->size == 0) return -1;
+
+    if (heap->count[0] == 0) {
+        int bucket = 1;
+        while (heap->count[bucket] == 0) bucket++;
+
+        RadixItem* items = heap->items[bucket];
+        int count = heap->count[bucket];
+        unsigned long long minKey = items[0].key;
+        for (int i = 1; i < count; i++) {
+            if (items[i].key < minKey) minKey = items[i].key;
+        }
+        // СļΪµlastЩ䵽bucket͵Ͱ
+        heap->last = minKey;
+        heap->count[bucket] = 0;
+        for (int i = 0; i < count; i++) {
+            if (!radixAppend(heap, radixBucket(items[i].key, minKey), items[i])) return -1;
+        }
+    }
+
+    RadixItem item = heap->items[0][--heap->count[0]];
+    heap->size--;
+    *key = item.key;
+    return item.userId;
+}
+// ͷŻѵĸͰ
+void freeRadixHeap(RadixHeap* heap) {
+    for (int i = 0; i < RADIX_HEAP_BUCKETS; i++) {
+        free(heap->items[i]);
+    }
+    memset(heap, 0, sizeof(RadixHeap));
+}
+// currentneighborľΪnewCostʱ֪Ķ²ѣڴ治㷵0
+int relaxWeighted(SearchScratch* scratch, RadixHeap* heap, int current, int neighbor, long long newCost) {
+    unsigned int epoch = scratch->epoch;
+    if (scratch->backMark[neighbor] == epoch) return 1;  // ȷ̾
+    if (scratch->visitMark[neighbor] == epoch && scratch->cost[neighbor] <= newCost) return 1;
+
+    scratch->visitMark[neighbor] = epoch;
+    scratch->cost[neighbor] = newCost;
+    scratch->parent[neighbor] = current;
+    return radixPush(heap, (unsigned long long)newCost, neighbor);
+}
+// DijkstraҼȨ·߳ǺѹϵȨأûм¼ʱ1BFSͬ
+// ·Ȩأ·ʽfindShortestPathͬɴûڻڴ治㷵-1
+// ͬһûڶзΣȡʱѾȷҪѵļС
+long long findWeightedPath(Graph* graph, int fromUserId, int toUserId, int* path, int* pathLength) {
+    if (!isValidUser(graph, fromUserId) || !isValidUser(graph, toUserId)) {
         return -1;  // û
     }
 
-    if (fromUserId == toUserId) {
-        path[0] = fromUserId;
-        *pathLength = 1;
-        return 0;  // 0ȣԼ
+    SearchScratch* scratch = getSearchScratch(graph);
+    if (scratch == NULL) {
+        printf("ڴʧܣ\n");
+        return -1;
+    }
+    // visitMarkоûbackMarkǾȷû
+    beginVisit(scratch);
+    unsigned int epoch = scratch->epoch;
+    RadixHeap heap;
+    memset(&heap, 0, sizeof(heap));
+    scratch->visitMark[fromUserId] = epoch;
+    scratch->cost[fromUserId] = 0;
+    scratch->parent[fromUserId] = -1;
+    bool ok = radixPush(&heap, 0, fromUserId);
+
+    long long result = -1;
+    unsigned long long key;
+    int current = 0;
+    while (ok && (current = radixPop(&heap, &key)) >= 0) {
+        if (scratch->backMark[current] == epoch || (long long)key != scratch->cost[current]) continue;
+        scratch->backMark[current] = epoch;
+        if (current == toUserId) {
+            result = scratch->cost[current];
+            break;
+        }
+
+        long long base = scratch->cost[current];
+        const int* row = graph->neighbors + graph->rowStart[current];
+        const EdgeAttr* rowAttr = (graph->neighborAttr == NULL) ? NULL :
+                                  graph->neighborAttr + graph->rowStart[current];
+        for (int i = 0; ok && i < graph->baseDegree[current]; i++) {
+            int weight = (rowAttr == NULL) ? DEFAULT_FRIEND_WEIGHT : rowAttr[i].weight;
+            ok = relaxWeighted(scratch, &heap, current, row[i], base + weight);
+        }
+        for (int i = graph->pendingHead[current]; ok && i >= 0; i = graph->pendingNext[i]) {
+            int weight = (graph->pendingAttr == NULL) ? DEFAULT_FRIEND_WEIGHT : graph->pendingAttr[i].weight;
+            ok = relaxWeighted(scratch, &heap, current, graph->pendingFriend[i], base + weight);
+        }
+    }
+    if (!ok || (heap.size > 0 && current < 0)) {
+        printf("ڴʧܣ\n");
+        result = -1;
+    }
+    freeRadixHeap(&heap);
+    if (result < 0) return -1;
+
+    // յظڵݣٷת
+    *pathLength = 0;
+    for (int node = toUserId; node != -1; node = scratch->parent[node]) {
+        path[(*pathLength)++] = node;
+    }
+    for (int i = 0; i < *pathLength / 2; i++) {
+        int temp = path[i];
+        path[i] = path[*pathLength - 1 - i];
+        path[*pathLength - 1 - i] = temp;
+    }
+    return result;
+}
+// ȡûIDĺбûºʱֱӷؿеУƵbuffer
+const int* getSortedFriends(const Graph* graph, int userId, int* buffer, int* count) {
+    if (graph->pendingHead[userId] < 0) {
+        *count = graph->baseDegree[userId];
+        return graph->neighbors + graph->rowStart[userId];
+    }
+
+    *count = 0;
+    FriendIterator it;
+    startFriendIterator(&it, graph, userId);
+    for (int friendId = nextFriend(&it); friendId >= 0; friendId = nextFriend(&it)) {
+        buffer[(*count)++] = friendId;
+    }
+    qsort(buffer, *count, sizeof(int), compareInts);
+    return buffer;
+}
+// 󽻼ͬʱɨ
+int intersectMerge(const int* a, int countA, const int* b, int countB, int* out) {
+    int i = 0, j = 0, count = 0;
+    while (i < countA && j < countB) {
+        if (a[i] < b[j]) {
+            i++;
+        } else if (a[i] > b[j]) {
+            j++;
+        } else {
+            out[count++] = a[i];
+            i++;
+            j++;
+        }
+    }
+    return count;
+}
+// 󽻼aԶbaÿԪbȰ124Ծٶ
+int intersectGallop(const int* a, int countA, const int* b, int countB, int* out) {
+    int count = 0, low = 0;
+    for (int i = 0; i < countA && low < countB; i++) {
+        int step = 1, high = low;
+        while (high < countB && b[high] < a[i]) {
+            low = high + 1;
+            high += step;
+            step *= 2;
+        }
+        if (high >= countB) high = countB - 1;
+
+        while (low <= high) {
+            int mid = (low + high) / 2;
+            if (b[mid] < a[i]) {
+                low = mid + 1;
+            } else {
+                high = mid - 1;
+            }
+        }
+        if (low < countB && b[low] == a[i]) {
+            out[count++] = a[i];
+            low++;
+        }
+    }
+    return count;
+}
+#if defined(__SSE2__)
+// 󽻼SSE2ÿȡab4bѭλ3Σһ4αȽϾҳȵԪ
+int intersectSimd(const int* a, int countA, const int* b, int countB, int* out) {
+    int i = 0, j = 0, count = 0;
+    while (i + 4 <= countA && j + 4 <= countB) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + j));
+        __m128i match = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi32(va, vb),
+                         _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+            _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+                         _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+
+        // kλΪ1ʾa[i + k]b4
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(match));
+        for (int k = 0; k < 4; k++) {
+            if (mask & (1 << k)) out[count++] = a[i + k];
+        }
+
+        // ֵСһѾȽֵ꣬ʱһǰ
+        int maxA = a[i + 3], maxB = b[j + 3];
+        if (maxA <= maxB) i += 4;
+        if (maxB <= maxA) j += 4;
+    }
+    return count + intersectMerge(a + i, countA - i, b + j, countB - j, out + count);
+}
+#endif
+// 󽻼ʱԾңϲ֧SSE2ʱ汾
+int intersectSorted(const int* a, int countA, const int* b, int countB, int* out) {
+    if (countA > countB) {
+        const int* temp = a;
+        a = b;
+        b = temp;
+        int tempCount = countA;
+        countA = countB;
+        countB = tempCount;
+    }
+    if (countA == 0) return 0;
+
+    if (countB / countA >= GALLOP_RATIO) {
+        return intersectGallop(a, countA, b, countB, out);
+    }
+#if defined(__SSE2__)
+    return intersectSimd(a, countA, b, countB, out);
+#else
+    return intersectMerge(a, countA, b, countB, out);
+#endif
+}
+// ȡVûĺλͼʱNULLһʹʱɲ棩
+const HubBitmap* getHubBitmap(Graph* graph, int userId, int friendCount) {
+    if ((long long)friendCount * HUB_BITMAP_RATIO < graph->userCapacity) return NULL;
+
+    if (graph->users[userId].hasHubBitmap) {
+        for (int i = 0; i < graph->hubCount; i++) {
+            if (graph->hubBitmaps[i].userId == userId) return &graph->hubBitmaps[i];
+        }
+    }
+
+    // Vû ܺѼ¼ * HUB_BITMAP_RATIO / û ԲҼ
+    if (graph->hubCount >= graph->hubCapacity) {
+        int newCapacity = (graph->hubCapacity == 0) ? 4 : graph->hubCapacity * 2;
+        HubBitmap* newHubs = (HubBitmap*)realloc(graph->hubBitmaps, newCapacity * sizeof(HubBitmap));
+        if (newHubs == NULL) return NULL;
+        graph->hubBitmaps = newHubs;
+        graph->hubCapacity = newCapacity;
+    }
+
+    HubBitmap* hub = &graph->hubBitmaps[graph->hubCount];
+    hub->bitCount = graph->userCapacity;
+    hub->bits = (unsigned long long*)calloc((hub->bitCount + 63) / 64, sizeof(unsigned long long));
+    if (hub->bits == NULL) return NULL;
+    hub->userId = userId;
+
+    FriendIterator it;
+    startFriendIterator(&it, graph, userId);
+    for (int friendId = nextFriend(&it); friendId >= 0; friendId = nextFriend(&it)) {
+        hub->bits[friendId / 64] |= 1ULL << (friendId % 64);
+    }
+    graph->hubCount++;
+    graph->users[userId].hasHubBitmap = true;
+    return hub;
+}
+// ҹͬѣID
+void findCommonFriends(Graph* graph, int userId1, int userId2,
+                       int* commonFriends, int* count) {
+    *count = 0;
+    if (!isValidUser(graph, userId1) || !isValidUser(graph, userId2)) return;
+
+    SearchScratch* scratch = getSearchScratch(graph);
+    if (scratch == NULL) return;
+
+    // ûбºδϲʱʱ
+    int count1, count2;
+    const int* friends1 = getSortedFriends(graph, userId1, scratch->queue, &count1);
+    const int* friends2 = getSortedFriends(graph, userId2, scratch->backQueue, &count2);
+    if (count1 > count2) {
+        const int* temp = friends1;
+        friends1 = friends2;
+        friends2 = temp;
+        int tempCount = count1;
+        count1 = count2;
+        count2 = tempCount;
+        tempCount = userId1;
+        userId1 = userId2;
+        userId2 = tempCount;
+    }
+
+    // ѶһǴVʱλͼжϺٵһֻ϶̵бй
+    const HubBitmap* hub = getHubBitmap(graph, userId2, count2);
+    if (hub != NULL) {
+        for (int i = 0; i < count1; i++) {
+            int friendId = friends1[i];
+            if (friendId < hub->bitCount && (hub->bits[friendId / 64] >> (friendId % 64) & 1)) {
+                commonFriends[(*count)++] = friendId;
+            }
+        }
+        return;
+    }
+
+    *count = intersectSorted(friends1, count1, friends2, count2, commonFriends);
+}
+// ƼѣѵĺѣųѾǺѵģ
+void recommendFriends(Graph* graph, int userId,
+                      int* recommendations, int* count) {
+    *count = 0;
+    if (!isValidUser(graph, userId)) return;
+
+    SearchScratch* scratch = getSearchScratch(graph);
+    if (scratch == NULL) return;
+
+    // ԼֱӺѣѱǵûƼ
+    beginVisit(scratch);
+    scratch->visitMark[userId] = scratch->epoch;
+    FriendIterator it;
+    startFriendIterator(&it, graph, userId);
+    for (int friendId = nextFriend(&it); friendId >= 0; friendId = nextFriend(&it)) {
+        scratch->visitMark[friendId] = scratch->epoch;
+    }
+
+    // ѵĺ
+    FriendIterator friendIt;
+    startFriendIterator(&friendIt, graph, userId);
+    for (int friendId = nextFriend(&friendIt); friendId >= 0; friendId = nextFriend(&friendIt)) {
+        startFriendIterator(&it, graph, friendId);
+        for (int friendOfFriend = nextFriend(&it); friendOfFriend >= 0;
+             friendOfFriend = nextFriend(&it)) {
+            // ųѾǺѵġԼѾƼ
+            if (scratch->visitMark[friendOfFriend] != scratch->epoch) {
+                recommendations[(*count)++] = friendOfFriend;
+                scratch->visitMark[friendOfFriend] = scratch->epoch;  // ظ
+            }
+        }
+    }
+}
+// жƼaǷӦbǰ棨÷ָߵǰιͬѶǰٴIDСǰ
+bool recommendationBefore(const Recommendation* a, const Recommendation* b) {
+    if (a->score != b->score) return a->score > b->score;
+    if (a->mutualCount != b->mutualCount) return a->mutualCount > b->mutualCount;
+    return a->userId < b->userId;
+}
+// С³ѶǵǰǰKģ
+void siftDownRecommendations(Recommendation* heap, int count, int i) {
+    while (1) {
+        int worst = i;
+        int left = 2 * i + 1, right = 2 * i + 2;
+        if (left < count && recommendationBefore(&heap[worst], &heap[left])) worst = left;
+        if (right < count && recommendationBefore(&heap[worst], &heap[right])) worst = right;
+        if (worst == i) return;
+
+        Recommendation temp = heap[i];
+        heap[i] = heap[worst];
+        heap[worst] = temp;
+        i = worst;
+    }
+}
+// ÷ƼѣͳÿѵĺѣѡˣĹͬAdamic-Adar÷֣ǰk
+// ѡ˵ĵ÷ۼ̵߳ʱУֻʺĺѡˣӸߵдout
+int recommendTopFriends(Graph* graph, int userId, Recommendation* out, int k) {
+    if (!isValidUser(graph, userId) || k <= 0) return 0;
+
+    SearchScratch* scratch = getSearchScratch(graph);
+    if (scratch == NULL) return 0;
+
+    // backMarkǲƼûԼкѣvisitMarkѾۼӹĺѡ
+    beginVisit(scratch);
+    unsigned int epoch = scratch->epoch;
+    scratch->backMark[userId] = epoch;
+    FriendIterator it;
+    startFriendIterator(&it, graph, userId);
+    for (int friendId = nextFriend(&it); friendId >= 0; friendId = nextFriend(&it)) {
+        scratch->backMark[friendId] = epoch;
+    }
+
+    int candidateCount = 0;
+    FriendIterator friendIt;
+    startFriendIterator(&friendIt, graph, userId);
+    for (int friendId = nextFriend(&friendIt); friendId >= 0; friendId = nextFriend(&friendIt)) {
+        int degree = getFriendCount(graph, friendId);
+        if (degree < 2) continue;  // ֻʶԼûпƼ
+        double weight = 1.0 / log(degree);
+
+        startFriendIterator(&it, graph, friendId);
+        for (int candidate = nextFriend(&it); candidate >= 0; candidate = nextFriend(&it)) {
+            if (scratch->backMark[candidate] == epoch) continue;
+            if (scratch->visitMark[candidate] != epoch) {
+                scratch->visitMark[candidate] = epoch;
+                scratch->score[candidate] = 0.0;
+                scratch->mutual[candidate] = 0;
+                scratch->queue[candidateCount++] = candidate;
+            }
+            scratch->score[candidate] += weight;
+            scratch->mutual[candidate]++;
+        }
+    }
+
+    // ôСΪkСѡǰk
+    int count = 0;
+    for (int i = 0; i < candidateCount; i++) {
+        Recommendation item;
+        item.userId = scratch->queue[i];
+        item.score = scratch->score[item.userId];
+        item.mutualCount = scratch->mutual[item.userId];
+
+        if (count < k) {
+            out[count++] = item;
+            if (count == k) {
+                for (int j = k / 2 - 1; j >= 0; j--) siftDownRecommendations(out, k, j);
+            }
+        } else if (recommendationBefore(&item, &out[0])) {
+            out[0] = item;
+            siftDownRecommendations(out, k, 0);
+        }
+    }
+    if (count < k) {
+        for (int j = count / 2 - 1; j >= 0; j--) siftDownRecommendations(out, count, j);
+    }
+
+    // ΰѶѶģĩβõӸߵ͵˳
+    for (int end = count - 1; end > 0; end--) {
+        Recommendation temp = out[0];
+        out[0] = out[end];
+        out[end] = temp;
+        siftDownRecommendations(out, end, 0);
+    }
+    return count;
+}
+// ƼΪûǰkout[userId * k]ʼŸûƼcounts[userId]
+// ʱ -fopenmp ̲߳м㣬ÿ߳ʹԼʱ
+void recommendForAllUsers(Graph* graph, int k, Recommendation* out, int* counts) {
+    int userLimit = graph->nextId;
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 256)
+#endif
+    for (int u = 1; u < userLimit; u++) {
+        counts[u] = graph->users[u].exists ?
+                    recommendTopFriends(graph, u, out + (long long)u * k, k) : 0;
+    }
+
+    // ͷŸ̵߳ʱ飨̵߳Ҳһͷţ´βѯʱ·䣩
+#ifdef _OPENMP
+    #pragma omp parallel
+#endif
+    freeSearchScratch();
+}
+// Ȧͨ- ʹBFScomponent鱾ǶУݹջ
+void findConnectedComponent(Graph* graph, int userId, int* component, int* count) {
+    *count = 0;
+    if (!isValidUser(graph, userId)) return;
+
+    SearchScratch* scratch = getSearchScratch(graph);
+    if (scratch == NULL) return;
+
+    beginVisit(scratch);
+    scratch->visitMark[userId] = scratch->epoch;
+    component[(*count)++] = userId;
+
+    for (int front = 0; front < *count; front++) {
+        FriendIterator it;
+        startFriendIterator(&it, graph, component[front]);
+        for (int friendId = nextFriend(&it); friendId >= 0; friendId = nextFriend(&it)) {
+            if (scratch->visitMark[friendId] != scratch->epoch) {
+                scratch->visitMark[friendId] = scratch->epoch;
+                component[(*count)++] = friendId;
+            }
+        }
+    }
+}
+// ǩȦÿÿûȡԼͺѱǩеСֱֵٱ仯
+// ÿֻһֵıǩֻдԼ±ǩԶ̲߳Уʱ -fopenmp
+// ǩҲͬһȦûÿ֮ȡһ"ǩıǩ"
+// ʱlabel[u]uȦСûID
+int propagateCircleLabels(const Graph* graph, int* label) {
+    int userLimit = graph->nextId;
+    int* next = (int*)malloc(userLimit * sizeof(int));
+    if (next == NULL) return 0;
+
+    for (int u = 0; u < userLimit; u++) {
+        label[u] = u;
+        next[u] = u;
+    }
+
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic, 1024) reduction(|:changed)
+#endif
+        for (int u = 1; u < userLimit; u++) {
+            int smallest = label[u];
+            FriendIterator it;
+            startFriendIterator(&it, graph, u);
+            for (int friendId = nextFriend(&it); friendId >= 0; friendId = nextFriend(&it)) {
+                if (label[friendId] < smallest) smallest = label[friendId];
+            }
+            next[u] = smallest;
+            if (smallest != label[u]) changed = 1;
+        }
+
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static)
+#endif
+        for (int u = 1; u < userLimit; u++) {
+            label[u] = next[next[u]];
+        }
+    }
+
+    free(next);
+    return 1;
+}
+// һȦcomponentId[u]ûuȦıţ0ʼڵûΪ-1
+// circleSizes[c]ǵcȦ鳤ȶСnextId
+// useLabelPropagationΪfalseʱò鼯ӺʱѾϲãΪtrueʱòбǩ
+// Ȧڴ治㷵-1
+int labelFriendCircles(Graph* graph, int* componentId, int* circleSizes, bool useLabelPropagation) {
+    SearchScratch* scratch = getSearchScratch(graph);
+    if (scratch == NULL) return -1;
+
+    // componentId[u]ȦĴû
+    if (useLabelPropagation) {
+        if (!propagateCircleLabels(graph, componentId)) return -1;
+    } else {
+        if (!graph->circlesValid) rebuildCircles(graph);
+        for (int u = 1; u < graph->nextId; u++) {
+            componentId[u] = findCircleRoot(graph, u);
+        }
+    }
+
+    // ٰѴûıţscratch->parent[û]·ֵıţ
+    beginVisit(scratch);
+    int count = 0;
+    componentId[0] = -1;
+    for (int u = 1; u < graph->nextId; u++) {
+        if (!graph->users[u].exists) {
+            componentId[u] = -1;
+            continue;
+        }
+
+        int representative = componentId[u];
+        if (scratch->visitMark[representative] != scratch->epoch) {
+            scratch->visitMark[representative] = scratch->epoch;
+            scratch->parent[representative] = count;
+            circleSizes[count++] = 0;
+        }
+        componentId[u] = scratch->parent[representative];
+        circleSizes[componentId[u]]++;
+    }
+    return count;
+}
+// Ȧֲhistogram[0]1˵Ȧhistogram[b](2^(b-1), 2^b]֮ĸ
+void buildCircleHistogram(const int* circleSizes, int circleCount, int* histogram) {
+    memset(histogram, 0, CIRCLE_HISTOGRAM_BUCKETS * sizeof(int));
+    for (int c = 0; c < circleCount; c++) {
+        int bucket = 0;
+        while ((1 << bucket) < circleSizes[c]) bucket++;
+        histogram[bucket]++;
+    }
+}
+// ʾȦͳϢ
+void displayCircleStatistics(Graph* graph) {
+    int* componentId = (int*)malloc(graph->nextId * sizeof(int));
+    int* circleSizes = (int*)malloc(graph->nextId * sizeof(int));
+    int circleCount = (componentId != NULL && circleSizes != NULL) ?
+                      labelFriendCircles(graph, componentId, circleSizes, false) : -1;
+    if (circleCount < 0) {
+        printf("ڴʧܣ\n");
+        free(componentId);
+        free(circleSizes);
+        return;
+    }
+
+    int largest = 0;
+    for (int c = 0; c < circleCount; c++) {
+        if (circleSizes[c] > largest) largest = circleSizes[c];
+    }
+    int histogram[CIRCLE_HISTOGRAM_BUCKETS];
+    buildCircleHistogram(circleSizes, circleCount, histogram);
+
+    printf("\n========== Ȧͳ ==========\n");
+    printf("Ȧ%d\n", circleCount);
+    printf("Ȧ%d\n", largest);
+    printf("ֲ\n");
+    for (int b = 0; b < CIRCLE_HISTOGRAM_BUCKETS; b++) {
+        if (histogram[b] == 0) continue;
+        int low = (b == 0) ? 1 : (1 << (b - 1)) + 1;
+        if (low == (1 << b)) {
+            printf("  %dˣ%d \n", low, histogram[b]);
+        } else {
+            printf("  %d-%dˣ%d \n", low, 1 << b, histogram[b]);
+        }
+    }
+    printf("================================\n\n");
+
+    free(componentId);
+    free(circleSizes);
+}
+// PageRankȡʽÿÿûӺѴռ һֵ÷/ѵĺ
+// ֻдԼµ÷֣ʱ -fopenmp ɶ̲߳Уûкѵûѵ÷ƽָ
+// rankȲСnextIdڵû÷Ϊ0صڴ治㷵-1
+int computePageRank(Graph* graph, double* rank) {
+    if (!mergePendingEdges(graph)) return -1;  // ѶCSRУжȡ
+
+    int userLimit = graph->nextId;
+    double* contribution = (double*)malloc(userLimit * sizeof(double));
+    if (contribution == NULL) return -1;
+
+    double userCount = graph->userCount > 0 ? graph->userCount : 1;
+    for (int u = 0; u < userLimit; u++) {
+        rank[u] = (u > 0 && graph->users[u].exists) ? 1.0 / userCount : 0.0;
+    }
+
+    int iteration = 0;
+    double difference = 1.0;
+    while (iteration < PAGERANK_MAX_ITERATIONS && difference >= PAGERANK_TOLERANCE) {
+        double dangling = 0.0;
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static) reduction(+:dangling)
+#endif
+        for (int u = 1; u < userLimit; u++) {
+            int degree = graph->baseDegree[u];
+            contribution[u] = (degree > 0) ? rank[u] / degree : 0.0;
+            if (degree == 0) dangling += rank[u];
+        }
+
+        double base = (1.0 - PAGERANK_DAMPING + PAGERANK_DAMPING * dangling) / userCount;
+        difference = 0.0;
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic, 1024) reduction(+:difference)
+#endif
+        for (int u = 1; u < userLimit; u++) {
+            if (!graph->users[u].exists) continue;
+
+            const int* row = graph->neighbors + graph->rowStart[u];
+            double sum = 0.0;
+            for (int i = 0; i < graph->baseDegree[u]; i++) {
+                sum += contribution[row[i]];
+            }
+            double newRank = base + PAGERANK_DAMPING * sum;
+            difference += (newRank > rank[u]) ? newRank - rank[u] : rank[u] - newRank;
+            rank[u] = newRank;  // ֻмcontributionʱrankһֱֿӸ
+        }
+        iteration++;
+    }
+
+    free(contribution);
+    return iteration;
+}
+// ûaǷûbǰ棺ٵǰͬʱIDСǰʱѹϵ
+bool rankedBefore(const Graph* graph, int a, int b) {
+    int degreeA = graph->baseDegree[a], degreeB = graph->baseDegree[b];
+    return degreeA < degreeB || (degreeA == degreeB && a < b);
+}
+// Σ˻Ϊѣÿѹϵֻǰָ˵ķ
+// ÿ u < v < wֻڴuĺvʱһΣȱuĺѣ
+// ٿvĺЩǡVĺѺ٣ҪĺѶࡣ
+// perUserΪNULLʱͬʱͳưÿûȲСnextId
+// ʱ -fopenmp ɶ̲߳Уڴ治㷵-1
+long long countTrianglesRanked(Graph* graph, long long* perUser) {
+    if (!mergePendingEdges(graph)) return -1;
+
+    int userLimit = graph->nextId;
+    int* forwardStart = (int*)malloc((userLimit + 1) * sizeof(int));
+    int* forward = (int*)malloc((graph->baseEdgeCount / 2 + 1) * sizeof(int));
+    if (forwardStart == NULL || forward == NULL) {
+        free(forwardStart);
+        free(forward);
+        return -1;
+    }
+
+    // ÿûĺηforward
+    int position = 0;
+    forwardStart[0] = 0;
+    for (int u = 0; u < userLimit; u++) {
+        const int* row = graph->neighbors + graph->rowStart[u];
+        for (int i = 0; i < graph->baseDegree[u]; i++) {
+            if (rankedBefore(graph, u, row[i])) forward[position++] = row[i];
+        }
+        forwardStart[u + 1] = position;
+    }
+    if (perUser != NULL) {
+        memset(perUser, 0, userLimit * sizeof(long long));
+    }
+
+    long long total = 0;
+    int failed = 0;
+#ifdef _OPENMP
+    #pragma omp parallel reduction(+:total)
+#endif
+    {
+        // mark[w] == u + 1 ʾwuĺѣÿuֻһΣգ
+        int* mark = (int*)calloc(userLimit, sizeof(int));
+        if (mark == NULL) failed = 1;
+
+#ifdef _OPENMP
+        #pragma omp for schedule(dynamic, 256)
+#endif
+        for (int u = 0; u < userLimit; u++) {
+            if (mark == NULL) continue;
+            for (int i = forwardStart[u]; i < forwardStart[u + 1]; i++) {
+                mark[forward[i]] = u + 1;
+            }
+
+            for (int i = forwardStart[u]; i < forwardStart[u + 1]; i++) {
+                int v = forward[i];
+                int found = 0;
+                for (int j = forwardStart[v]; j < forwardStart[v + 1]; j++) {
+                    int w = forward[j];
+                    if (mark[w] != u + 1) continue;
+                    found++;
+                    if (perUser != NULL) {
+#ifdef _OPENMP
+                        #pragma omp atomic
+#endif
+                        perUser[w]++;
+                    }
+                }
+                total += found;
+                if (perUser == NULL || found == 0) continue;
+
+#ifdef _OPENMP
+                #pragma omp atomic
+#endif
+                perUser[u] += found;
+#ifdef _OPENMP
+                #pragma omp atomic
+#endif
+                perUser[v] += found;
+            }
+        }
+        free(mark);
+    }
+
+    free(forwardStart);
+    free(forward);
+    return failed ? -1 : total;
+}
+// ͳΣ˻Ϊѣڴ治㷵-1
+long long countTriangles(Graph* graph) {
+    return countTrianglesRanked(graph, NULL);
+}
+// ÿûľϵ֮以Ϊѵı = û / (d * (d - 1) / 2)
+// 2ûϵΪ0coefficientȲСnextId
+// ûƽϵڴ治㷵-1
+double computeClusteringCoefficients(Graph* graph, double* coefficient) {
+    long long* triangles = (long long*)malloc(graph->nextId * sizeof(long long));
+    if (triangles == NULL || countTrianglesRanked(graph, triangles) < 0) {
+        free(triangles);
+        return -1.0;
+    }
+
+    double sum = 0.0;
+    coefficient[0] = 0.0;
+    for (int u = 1; u < graph->nextId; u++) {
+        double degree = graph->baseDegree[u];
+        coefficient[u] = (degree >= 2) ? 2.0 * triangles[u] / (degree * (degree - 1)) : 0.0;
+        sum += coefficient[u];
+    }
+    free(triangles);
+    return graph->userCount > 0 ? sum / graph->userCount : 0.0;
+}
+// ʾӰPageRankǰָ꣨ƽϵ
+void displayInfluenceStatistics(Graph* graph) {
+    double* rank = (double*)malloc(graph->nextId * sizeof(double));
+    double* coefficient = (double*)malloc(graph->nextId * sizeof(double));
+    int iterations = (rank != NULL) ? computePageRank(graph, rank) : -1;
+    long long triangles = countTriangles(graph);
+    double averageCoefficient = (coefficient != NULL) ?
+                                computeClusteringCoefficients(graph, coefficient) : -1.0;
+    if (iterations < 0 || triangles < 0 || averageCoefficient < 0) {
+        printf("ڴʧܣ\n");
+        free(rank);
+        free(coefficient);
+        return;
+    }
+
+    // ѡ÷ߵļûѡк÷ʱĳɸ
+    printf("\n========== Ӱ ==========\n");
+    printf("ӰУPageRank %d ֣\n", iterations);
+    int top[INFLUENCE_TOP_COUNT];
+    int topCount = 0;
+    for (; topCount < INFLUENCE_TOP_COUNT && topCount < graph->userCount; topCount++) {
+        int best = -1;
+        for (int u = 1; u < graph->nextId; u++) {
+            if (graph->users[u].exists && rank[u] >= 0 && (best < 0 || rank[u] > rank[best])) best = u;
+        }
+        top[topCount] = best;
+        printf("  %2d. û %d: %s÷ %.6f %d ϵ %.3f\n",
+               topCount + 1, best, graph->users[best].name, rank[best],
+               getFriendCount(graph, best), coefficient[best]);
+        rank[best] = -rank[best] - 1.0;
+    }
+    for (int i = 0; i < topCount; i++) {
+        rank[top[i]] = -(rank[top[i]] + 1.0);
+    }
+    printf("Σ˻Ϊѣ%lld\n", triangles);
+    printf("ƽϵ%.4f\n", averageCoefficient);
+    printf("==================================\n\n");
+
+    free(rank);
+    free(coefficient);
+}
+// ѹϵб׷һԺѣڴ治㷵0
+int appendEdge(EdgeList* list, int from, int to) {
+    if (list->count >= list->capacity) {
+        long long newCapacity = (list->capacity == 0) ? INIT_EDGE_LIST_CAPACITY : list->capacity * 2;
+        int* newFrom = (int*)realloc(list->from, newCapacity * sizeof(int));
+        if (newFrom == NULL) return 0;
+        list->from = newFrom;
+        int* newTo = (int*)realloc(list->to, newCapacity * sizeof(int));
+        if (newTo == NULL) return 0;
+        list->to = newTo;
+        list->capacity = newCapacity;
+    }
+
+    list->from[list->count] = from;
+    list->to[list->count] = to;
+    list->count++;
+    if (from > list->maxId) list->maxId = from;
+    if (to > list->maxId) list->maxId = to;
+    return 1;
+}
+// ¼һûIDԼԼIDϷ
+int acceptEdge(EdgeList* list, long long from, long long to) {
+    if (from < 1 || to < 1 || from >= INT_MAX || to >= INT_MAX || from == to) return 1;
+    return appendEdge(list, (int)from, (int)to);
+}
+// ıʽÿûIDո򶺺ŷָ#%ͷע
+// ַfscanfö
+int readTextEdges(FILE* file, EdgeList* list) {
+    char* buffer = (char*)malloc(LOAD_BUFFER_SIZE);
+    if (buffer == NULL) return 0;
+
+    long long fields[2] = {0, 0};
+    int fieldCount = 0;          // ǰѶָ
+    long long value = 0;
+    bool inNumber = false, inComment = false;
+    size_t length;
+    while ((length = fread(buffer, 1, LOAD_BUFFER_SIZE, file)) > 0) {
+        for (size_t i = 0; i < length; i++) {
+            char c = buffer[i];
+            if (inComment) {
+                if (c == '\n') inComment = false;
+                continue;
+            }
+            if (c >= '0' && c <= '9') {
+                if (value < INT_MAX) value = value * 10 + (c - '0');
+                inNumber = true;
+                continue;
+            }
+
+            if (inNumber) {
+                if (fieldCount < 2) fields[fieldCount] = value;
+                fieldCount++;
+                value = 0;
+                inNumber = false;
+            }
+            if (c == '\n') {
+                if (fieldCount >= 2 && !acceptEdge(list, fields[0], fields[1])) {
+                    free(buffer);
+                    return 0;
+                }
+                fieldCount = 0;
+            } else if ((c == '#' || c == '%') && fieldCount == 0) {
+                inComment = true;
+            }
+        }
+    }
+
+    // һпûлз
+    if (inNumber && fieldCount < 2) fields[fieldCount++] = value;
+    free(buffer);
+    if (fieldCount >= 2) return acceptEdge(list, fields[0], fields[1]);
+    return 1;
+}
+// Ƹʽδŵintԣֽ򣩣ÿûID
+int readBinaryEdges(FILE* file, EdgeList* list) {
+    int* buffer = (int*)malloc(LOAD_BUFFER_SIZE);
+    if (buffer == NULL) return 0;
+
+    size_t length;
+    while ((length = fread(buffer, 2 * sizeof(int), LOAD_BUFFER_SIZE / (2 * sizeof(int)), file)) > 0) {
+        for (size_t i = 0; i < length; i++) {
+            if (!acceptEdge(list, buffer[2 * i], buffer[2 * i + 1])) {
+                free(buffer);
+                return 0;
+            }
+        }
+    }
+    free(buffer);
+    return 1;
+}
+// ѹϵȷϣϵĴСװʲ3/4
+int edgeSetBitsFor(long long edgeCount) {
+    int bits = INIT_EDGE_SET_BITS;
+    while (edgeCount * 4 > (3LL << bits)) bits++;
+    return bits;
+}
+// 64λ1ĸ
+int countBits(unsigned long long x) {
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((x * 0x0101010101010101ULL) >> 56);
+}
+// ͳļгֹĲͬûIDIDϡ裨IDͬIDIMPORT_REMAP_RATIOʱ
+// ±õǰ׺prefixΪNULLԭIDͼڴ治㷵0
+int buildIdRemap(const EdgeList* list, IdRemap* remap) {
+    long long words = (long long)list->maxId / 64 + 1;
+    remap->present = (unsigned long long*)calloc(words, sizeof(unsigned long long));
+    remap->prefix = NULL;
+    remap->distinct = 0;
+    if (remap->present == NULL) return 0;
+
+    for (long long i = 0; i < list->count; i++) {
+        remap->present[list->from[i] >> 6] |= 1ULL << (list->from[i] & 63);
+        remap->present[list->to[i] >> 6] |= 1ULL << (list->to[i] & 63);
+    }
+    for (long long w = 0; w < words; w++) {
+        remap->distinct += countBits(remap->present[w]);
+    }
+    if (list->maxId <= (long long)remap->distinct * IMPORT_REMAP_RATIO) return 1;
+
+    remap->prefix = (int*)malloc(words * sizeof(int));
+    if (remap->prefix == NULL) {
+        free(remap->present);
+        remap->present = NULL;
+        return 0;
+    }
+    int ones = 0;
+    for (long long w = 0; w < words; w++) {
+        remap->prefix[w] = ones;
+        ones += countBits(remap->present[w]);
+    }
+    return 1;
+}
+// ļеûIDӦͼûIDҪ±ʱԭID
+int remapUserId(const IdRemap* remap, int id) {
+    if (remap->prefix == NULL) return id;
+    unsigned long long atOrBelow = remap->present[id >> 6] & ((2ULL << (id & 63)) - 1);
+    return remap->prefix[id >> 6] + countBits(atOrBelow);
+}
+// CSRոؽѹϵϣϣÿѹϵڽСIDһһΣڴ治㷵0
+int rebuildEdgeSetFromRows(Graph* graph) {
+    free(graph->edgeSet.keys);
+    graph->edgeSet.keys = NULL;
+    graph->edgeSet.count = 0;
+
+    // һη䵽λñ߲
+    if (!edgeSetResize(&graph->edgeSet, edgeSetBitsFor(graph->baseEdgeCount / 2))) return 0;
+    for (int u = 1; u < graph->nextId; u++) {
+        const int* row = graph->neighbors + graph->rowStart[u];
+        for (int i = 0; i < graph->baseDegree[u]; i++) {
+            if (row[i] > u) edgeSetInsert(&graph->edgeSet, edgeKey(u, row[i]));
+        }
+    }
+    return 1;
+}
+// ѺѹϵбֱӽCSRգÿûĺǰ׺͵õÿ㣬
+// ٰѺУ򣩣ÿȥأ⼸ʱ -fopenmp Ტִ
+// ļеûIDϡʱֻȡ˴ݼһ֣С±Ϊ1..nû"û+ԭID"
+Graph* buildGraphFromEdges(const EdgeList* list) {
+    if (list->count * 2 > INT_MAX) {
+        printf("ѹϵ̫࣬޷룡\n");
+        return NULL;
+    }
+
+    IdRemap remap;
+    if (!buildIdRemap(list, &remap)) {
+        printf("ڴʧܣ\n");
+        return NULL;
+    }
+    int userLimit = (remap.prefix != NULL) ? remap.distinct : list->maxId;  // ͼеûID
+    if (remap.prefix != NULL) {
+        printf("ûIDϡ裨ID %dʵ %d ûѰС±\n", list->maxId, remap.distinct);
+    }
+
+    long long userCapacity = INIT_USER_CAPACITY;
+    while (userCapacity <= userLimit) userCapacity *= 2;
+    Graph* graph = (userCapacity <= MAX_USER_CAPACITY) ? createGraph((int)userCapacity) : NULL;
+    if (graph == NULL) {
+        if (userCapacity > MAX_USER_CAPACITY) printf("û̫࣬޷룡\n");
+        free(remap.present);
+        free(remap.prefix);
+        return NULL;
+    }
+
+    // ͼIDڵû±ʱλͼȡԭIDΪ
+    long long word = 0;
+    unsigned long long bits = remap.present[0];
+    for (int u = 1; u <= userLimit; u++) {
+        int originalId = u;
+        if (remap.prefix != NULL) {
+            while (bits == 0) bits = remap.present[++word];
+            int bit = countBits((bits & (~bits + 1)) - 1);  // λ1ڵڼλ
+            bits &= bits - 1;
+            originalId = (int)(word * 64 + bit);
+        }
+        graph->users[u].id = u;
+        sprintf(graph->users[u].name, "û%d", originalId);
+        graph->users[u].exists = true;
+    }
+    graph->nextId = userLimit + 1;
+    graph->userCount = userLimit;
+
+    int* cursor = (int*)malloc(userCapacity * sizeof(int));
+    graph->neighbors = (int*)malloc((list->count > 0 ? list->count * 2 : 1) * sizeof(int));
+    if (cursor == NULL || graph->neighbors == NULL) {
+        printf("ڴʧܣ\n");
+        free(cursor);
+        free(remap.present);
+        free(remap.prefix);
+        freeGraph(graph);
+        return NULL;
+    }
+
+    // ÿûĺظĺѹϵȥǰҲڣ
+    int* degree = graph->baseDegree;  // createGraph
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for (long long i = 0; i < list->count; i++) {
+        int from = remapUserId(&remap, list->from[i]);
+        int to = remapUserId(&remap, list->to[i]);
+#ifdef _OPENMP
+        #pragma omp atomic
+#endif
+        degree[from]++;
+#ifdef _OPENMP
+        #pragma omp atomic
+#endif
+        degree[to]++;
+    }
+
+    int position = 0;
+    for (int u = 0; u < userCapacity; u++) {
+        graph->rowStart[u] = position;
+        cursor[u] = position;
+        position += degree[u];
+    }
+    graph->rowStart[userCapacity] = position;
+
+    // Уʱͬһڵ˳ȷ
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for (long long i = 0; i < list->count; i++) {
+        int from = remapUserId(&remap, list->from[i]);
+        int to = remapUserId(&remap, list->to[i]);
+        int slot1, slot2;
+#ifdef _OPENMP
+        #pragma omp atomic capture
+#endif
+        slot1 = cursor[from]++;
+#ifdef _OPENMP
+        #pragma omp atomic capture
+#endif
+        slot2 = cursor[to]++;
+        graph->neighbors[slot1] = to;
+        graph->neighbors[slot2] = from;
+    }
+    free(cursor);
+    free(remap.present);
+    free(remap.prefix);
+
+    // ÿȥأظĺβʹãβпλ
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 1024)
+#endif
+    for (int u = 1; u < graph->nextId; u++) {
+        int* row = graph->neighbors + graph->rowStart[u];
+        if (degree[u] <= 1) continue;
+
+        qsort(row, degree[u], sizeof(int), compareInts);
+        int unique = 1;
+        for (int i = 1; i < degree[u]; i++) {
+            if (row[i] != row[unique - 1]) row[unique++] = row[i];
+        }
+        degree[u] = unique;
+    }
+
+    long long neighborCount = 0;
+    for (int u = 1; u < graph->nextId; u++) {
+        neighborCount += degree[u];
+    }
+    graph->baseEdgeCount = (int)neighborCount;
+
+    if (!rebuildEdgeSetFromRows(graph)) {
+        printf("ڴʧܣ\n");
+        freeGraph(graph);
+        return NULL;
+    }
+
+    recountDegrees(graph);
+    if (!rebuildUserIndexes(graph)) {
+        printf("ڴʧܣ\n");
+        freeGraph(graph);
+        return NULL;
+    }
+    graph->circlesValid = false;  // һβѯȦʱٽ鼯
+    return graph;
+}
+// Ӻѹϵбļ룬µͼûļеIDΪ"û+ID"
+// binaryΪtrueʱƸʽıʽʧܷNULL
+Graph* loadEdgeList(const char* fileName, bool binary) {
+    FILE* file = fopen(fileName, binary ? "rb" : "r");
+    if (file == NULL) {
+        printf("޷ļ %s\n", fileName);
+        return NULL;
+    }
+
+    EdgeList list = {NULL, NULL, 0, 0, 0};
+    int ok = binary ? readBinaryEdges(file, &list) : readTextEdges(file, &list);
+    fclose(file);
+
+    Graph* graph = NULL;
+    if (!ok) {
+        printf("ڴʧܣ\n");
+    } else {
+        graph = buildGraphFromEdges(&list);
+    }
+    free(list.from);
+    free(list.to);
+    return graph;
+}
+// ͼգȰ׷ӻϲCSRգɹ1
+int saveGraphSnapshot(Graph* graph, const char* fileName) {
+    if (!mergePendingEdges(graph)) return 0;
+
+    FILE* file = fopen(fileName, "wb");
+    if (file == NULL) {
+        printf("޷ļ %s\n", fileName);
+        return 0;
+    }
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.nextId = graph->nextId;
+    header.userCount = graph->userCount;
+    header.edgeSetBits = graph->edgeSet.bits;
+    header.edgeSetCount = graph->edgeSet.count;
+    header.neighborCount = graph->baseEdgeCount;
+
+    // ֮ɾµĿλдʹļеĺѽ
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(graph->users, sizeof(User), graph->nextId, file) == (size_t)graph->nextId &&
+              fwrite(graph->baseDegree, sizeof(int), graph->nextId, file) == (size_t)graph->nextId;
+    for (int u = 0; ok && u < graph->nextId; u++) {
+        ok = fwrite(graph->neighbors + graph->rowStart[u], sizeof(int), graph->baseDegree[u], file) ==
+             (size_t)graph->baseDegree[u];
+    }
+    if (ok && graph->edgeSet.keys != NULL) {
+        size_t slots = (size_t)1 << graph->edgeSet.bits;
+        ok = fwrite(graph->edgeSet.keys, sizeof(unsigned long long), slots, file) == slots;
+    }
+    if (ok && graph->neighborAttr != NULL) {
+        unsigned int marker = SNAPSHOT_ATTR_MAGIC;
+        ok = fwrite(&marker, sizeof(marker), 1, file) == 1;
+        for (int u = 0; ok && u < graph->nextId; u++) {
+            ok = fwrite(graph->neighborAttr + graph->rowStart[u], sizeof(EdgeAttr), graph->baseDegree[u],
+                        file) == (size_t)graph->baseDegree[u];
+        }
+    }
+
+    if (fclose(file) != 0) ok = false;
+    if (!ok) printf("дļ %s ʧܣ\n", fileName);
+    return ok;
+}
+// ļеbytesֽڣfseekܷʾƫƣļβfalse
+bool skipFileBytes(FILE* file, long long bytes) {
+    char* buffer = (char*)malloc(LOAD_BUFFER_SIZE);
+    if (buffer == NULL) return false;
+    while (bytes > 0) {
+        size_t chunk = (bytes < LOAD_BUFFER_SIZE) ? (size_t)bytes : LOAD_BUFFER_SIZE;
+        if (fread(buffer, 1, chunk, file) != chunk) break;
+        bytes -= chunk;
+    }
+    free(buffer);
+    return bytes == 0;
+}
+// ûͺУ'\0'βID [1, nextId) ڡǴڵûԼ
+// ÿϸûظڵûûкѣͬʱû
+bool validateSnapshotRows(Graph* graph) {
+    graph->userCount = 0;
+    for (int u = 0; u < graph->nextId; u++) {
+        User* user = &graph->users[u];
+        unsigned char exists;
+        memcpy(&exists, &user->exists, 1);  // ļеboolܲ01ֽڼ
+        if (exists > 1 || (u == 0 && exists) || memchr(user->name, '\0', MAX_NAME_LEN) == NULL) return false;
+        user->hasHubBitmap = false;
+        if (!user->exists) {
+            if (graph->baseDegree[u] != 0) return false;
+            continue;
+        }
+        if (user->id != u) return false;
+        graph->userCount++;
+    }
+
+    for (int u = 1; u < graph->nextId; u++) {
+        const int* row = graph->neighbors + graph->rowStart[u];
+        for (int i = 0; i < graph->baseDegree[u]; i++) {
+            int v = row[i];
+            if (v < 1 || v >= graph->nextId || v == u || !graph->users[v].exists) return false;
+            if (i > 0 && v <= row[i - 1]) return false;
+        }
+    }
+    return true;
+}
+// ѹϵ˫ģСIDһĺѶѽ˹ϣϣϴIDһĺҲҪڼУ
+// ҺѼ¼Ǽ
+bool snapshotRowsSymmetric(const Graph* graph) {
+    if ((long long)graph->edgeSet.count * 2 != graph->baseEdgeCount) return false;
+    for (int u = 1; u < graph->nextId; u++) {
+        const int* row = graph->neighbors + graph->rowStart[u];
+        for (int i = 0; i < graph->baseDegree[u] && row[i] < u; i++) {
+            if (edgeSetFind(&graph->edgeSet, edgeKey(u, row[i])) < 0) return false;
+        }
+    }
+    return true;
+}
+// ͼգµͼļԻڴ治㷵NULL
+// ļеݶҪʹãѹϵϣϲֱӶ룬ɺؽûexists
+Graph* loadGraphSnapshot(const char* fileName) {
+    FILE* file = fopen(fileName, "rb");
+    if (file == NULL) {
+        printf("޷ļ %s\n", fileName);
+        return NULL;
+    }
+
+    SnapshotHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != SNAPSHOT_MAGIC ||
+        header.version != SNAPSHOT_VERSION || header.nextId < 1 || header.nextId > MAX_USER_CAPACITY ||
+        header.neighborCount < 0 || header.neighborCount > INT_MAX ||
+        header.edgeSetBits < 0 || header.edgeSetBits > 30) {
+        printf("ļ %s Чͼգ\n", fileName);
+        fclose(file);
+        return NULL;
+    }
+
+    long long userCapacity = INIT_USER_CAPACITY;
+    while (userCapacity < header.nextId) userCapacity *= 2;
+    Graph* graph = createGraph((int)userCapacity);
+    if (graph == NULL) {
+        fclose(file);
+        return NULL;
+    }
+
+    graph->nextId = header.nextId;
+    graph->neighbors = (int*)malloc((header.neighborCount > 0 ? header.neighborCount : 1) * sizeof(int));
+    if (graph->neighbors == NULL) {
+        printf("ڴʧܣ\n");
+        fclose(file);
+        freeGraph(graph);
+        return NULL;
+    }
+
+    // ļбĺѹϵϣֻɺؽ
+    long long slots = (header.edgeSetBits > 0) ? 1LL << header.edgeSetBits : 0;
+    bool ok = fread(graph->users, sizeof(User), header.nextId, file) == (size_t)header.nextId &&
+              fread(graph->baseDegree, sizeof(int), header.nextId, file) == (size_t)header.nextId &&
+              fread(graph->neighbors, sizeof(int), header.neighborCount, file) ==
+                  (size_t)header.neighborCount &&
+              skipFileBytes(file, slots * (long long)sizeof(unsigned long long));
+    EdgeAttr* attrs = NULL;
+    unsigned int marker;
+    if (ok && fread(&marker, sizeof(marker), 1, file) == 1 && marker == SNAPSHOT_ATTR_MAGIC) {
+        attrs = (EdgeAttr*)malloc((header.neighborCount > 0 ? header.neighborCount : 1) * sizeof(EdgeAttr));
+        ok = attrs != NULL && fread(attrs, sizeof(EdgeAttr), header.neighborCount, file) ==
+                                  (size_t)header.neighborCount;
+        for (long long i = 0; ok && i < header.neighborCount; i++) {
+            if (attrs[i].weight <= 0 || attrs[i].interactions < 0) ok = false;
+        }
+    }
+    fclose(file);
+
+    // ÿеĺÿ㣬ļͷһ
+    long long position = 0;
+    for (int u = 0; ok && u < userCapacity; u++) {
+        if (graph->baseDegree[u] < 0) ok = false;
+        graph->rowStart[u] = (int)position;
+        position += graph->baseDegree[u];
+        if (position > header.neighborCount) ok = false;
+    }
+    graph->rowStart[userCapacity] = (int)position;
+    graph->baseEdgeCount = (int)header.neighborCount;
+    if (!ok || position != header.neighborCount || !validateSnapshotRows(graph)) {
+        printf("ļ %s Чͼգ\n", fileName);
+        free(attrs);
+        freeGraph(graph);
+        return NULL;
+    }
+
+    if (!rebuildEdgeSetFromRows(graph)) {
+        printf("ڴʧܣ\n");
+        free(attrs);
+        freeGraph(graph);
+        return NULL;
+    }
+    if (!snapshotRowsSymmetric(graph)) {
+        printf("ļ %s Чͼգ\n", fileName);
+        free(attrs);
+        freeGraph(graph);
+        return NULL;
+    }
+
+    recountDegrees(graph);
+    if (!rebuildUserIndexes(graph) || (attrs != NULL && !enableEdgeAttributes(graph))) {
+        printf("ڴʧܣ\n");
+        free(attrs);
+        freeGraph(graph);
+        return NULL;
+    }
+    if (attrs != NULL) {
+        memcpy(graph->neighborAttr, attrs, header.neighborCount * sizeof(EdgeAttr));
+        free(attrs);
+        for (int u = 1; u < graph->nextId; u++) {
+            rebuildStrongTies(graph, u);
+        }
+    }
+    graph->circlesValid = false;
+    return graph;
+}
+#if ENABLE_CONCURRENT_GRAPH
+// ģʽڲɱĿϲѯдȽУɺϲ߳
+// дͼУ°汾Ŀԭӵط
+// ¿ֻһĶĺиƽһ¿飬ɿչãһεĴĶ
+// ûȣֻеһ帴ƣ֮ɿвõĿռÿη˳Ƽջ
+// ӳٵĿƣһηMAX_PUBLISH_BATCHдηʱޣдȵ
+// maxStalenessMsһϲ߳̾ȡУһϲ̰߳ķٶķ֮һ
+// ʱܷܵôдѵһʱ仹ûȡʱдߵȴ
+// Щֻ֤ϲֵܷ߳CPUʱӳٲmaxStalenessMs߳ռCPUʱԿܳ
+// ܲԱ泬Ŀӳٵд
+// 滻ľɿȹڴͷϣȷûжߵǼúͷţΣָ룩
+// һеȫ滻滻ǰĿնͷźͷ
+
+// ֻĺѹϵգÿаID򣬷޸
+typedef struct ConcurrentSnapshot {
+    long long version;           // 汾ţÿһμ1
+    int userLimit;               // ûIDΧ [1, userLimit)
+    const int** rows;            // ûuĺ rows[u][0]  rows[u][rowLength[u] - 1]ûкʱΪNULL
+    int* rowLength;              // ûĶһ汾ָͬһ
+    struct ConcurrentSnapshot* nextRetired; // 滻ڴͷеһ
+} ConcurrentSnapshot;
+
+// һηʱƵĺзͬһУݽڽṹ
+typedef struct RowBlock {
+    long long size;              // е
+    int liveRows;                // ǰлָ
+    long long replacedIn;        // liveRowsΪ0ʱİ汾汾Ŀնͷźͷ
+    struct RowBlock* next;
+} RowBlock;
+
+// еһд
+typedef struct {
+    int userId1;
+    int userId2;
+    bool add;                    // trueΪӺѣfalseΪɾ
+    long long queuedNanos;       // ʱ
+} EdgeMutation;
+
+typedef struct {
+    Graph* graph;                // ֻкϲ߳޸ģûڲģʽ²䣬д߿Զ
+    _Atomic(ConcurrentSnapshot*) current;                    // ǰĿ
+    _Atomic(ConcurrentSnapshot*) hazards[MAX_READER_THREADS]; // ÿ߳ʹõĿ
+    atomic_bool readerUsed[MAX_READER_THREADS];               // ǼλǷѱ߳ռ
+    ConcurrentSnapshot* retired; // ѱ滻ܻжõĿգֻкϲ̷߳ʣ
+
+    // ֻкϲ̷߳
+    RowBlock* blocks;            // ûͷŵĿ
+    RowBlock** rowBlock;         // rowBlock[u]ǵǰûuڵĿ飬ûкʱΪNULL
+    long long heldInts;          // ǰջõĿܴСѹϵ϶ʱʼջؿռ
+    int compactCursor;           // һҪ¸ջؿռû
+    int* dirtyUsers;             // иĶûƽյûʧʱһ
+    int dirtyCount;
+    bool* dirtyMark;             // dirtyMark[u]ʾudirtyUsers
+
+    // дУqueueLock
+    mtx_t queueLock;
+    cnd_t queueReady;            // ܹһҪˢ»ֹͣʱ֪ͨϲ߳
+    cnd_t queueApplied;          // һд֪ͨȴˢµ߳
+    EdgeMutation* queue;
+    int queueCount;
+    int queueCapacity;
+    long long firstQueuedNanos;  // һдʱ䣨Ϊʱ壩
+    int queueLimit;              // ômergeBatchٶȹƣĿӳٵһڷ
+    long long queuedTotal;       // ۼӵд
+    long long appliedTotal;      // ۼѷд
+    bool flushRequested;
+    bool stopping;
+
+    int maxStalenessMs;          // Ŀӳ٣룩
+    int mergeBatch;              // ܹôϲ
+    thrd_t mergeThread;
+
+    // ͳƣϲ߳д룬ֹͣȡ
+    long long publishCount;      // Ŀ
+    long long lastBuildNanos;    // һκϲɿյʱȴʱԤ
+    long long recentPublishNanos; // ʱд˥Ʒٶ
+    long long recentPublishWrites;
+    long long visibleWrites;     // ѷд
+    long long lateWrites;        // дӵɼmaxStalenessMs
+    long long totalStalenessNanos; // ÿдӵɼʱ֮
+    long long maxStalenessNanos; // ʵʳֹӳ
+    long long unpublishedNanos;  // ʧһεдʱ䣨ûʱΪ0
+    int unpublishedCount;
+} ConcurrentGraph;
+
+static _Thread_local ConcurrentGraph* readerGraph = NULL; // ǰ̵߳ǼڵĲͼ
+static _Thread_local int readerSlot = -1;                 // ǰ̵߳ĵǼλ
+
+// ͷſյбڿУɺϲ߳ͷţ
+void freeConcurrentSnapshot(ConcurrentSnapshot* snapshot) {
+    if (snapshot == NULL) return;
+    free(snapshot->rows);
+    free(snapshot->rowLength);
+    free(snapshot);
+}
+// °汾ĿգfullΪtrueʱȫûĺУֻƸĶûold
+// ƵжŽһ¿飬*newBlockأûиκκʱΪNULLڴ治㷵NULLcg
+ConcurrentSnapshot* buildConcurrentSnapshot(ConcurrentGraph* cg, const ConcurrentSnapshot* old,
+                                            bool full, RowBlock** newBlock) {
+    const Graph* graph = cg->graph;
+    int userLimit = graph->nextId;
+    int count = full ? userLimit : cg->dirtyCount;
+    long long total = 0;
+    for (int i = 0; i < count; i++) {
+        total += getFriendCount(graph, full ? i : cg->dirtyUsers[i]);
+    }
+
+    ConcurrentSnapshot* snapshot = (ConcurrentSnapshot*)malloc(sizeof(ConcurrentSnapshot));
+    if (snapshot == NULL) return NULL;
+    snapshot->version = (old != NULL) ? old->version + 1 : 1;
+    snapshot->userLimit = userLimit;
+    snapshot->nextRetired = NULL;
+    snapshot->rows = (const int**)malloc((userLimit > 0 ? userLimit : 1) * sizeof(int*));
+    snapshot->rowLength = (int*)malloc((userLimit > 0 ? userLimit : 1) * sizeof(int));
+    RowBlock* block = NULL;
+    if (total > 0) block = (RowBlock*)malloc(sizeof(RowBlock) + total * sizeof(int));
+    if (snapshot->rows == NULL || snapshot->rowLength == NULL || (total > 0 && block == NULL)) {
+        free(block);
+        freeConcurrentSnapshot(snapshot);
+        return NULL;
+    }
+
+    if (!full) {
+        memcpy(snapshot->rows, old->rows, userLimit * sizeof(int*));
+        memcpy(snapshot->rowLength, old->rowLength, userLimit * sizeof(int));
+    }
+    int* data = (block != NULL) ? (int*)(block + 1) : NULL;
+    long long pos = 0;
+    for (int i = 0; i < count; i++) {
+        int u = full ? i : cg->dirtyUsers[i];
+        int length = (getFriendCount(graph, u) > 0) ? copySortedRow(graph, u, data + pos) : 0;
+        snapshot->rows[u] = (length > 0) ? data + pos : NULL;
+        snapshot->rowLength[u] = length;
+        pos += length;
+    }
+    if (block != NULL) {
+        block->size = total;
+        block->liveRows = 0;
+        block->replacedIn = 0;
+        block->next = NULL;
+    }
+    *newBlock = block;
+    return snapshot;
+}
+// ¿շǰ¿ļ¼滻дԭĿм¿ӹܸƵ
+// ؽʱоɿ鶼汾滻
+void adoptRowBlock(ConcurrentGraph* cg, const ConcurrentSnapshot* snapshot, RowBlock* block, bool full) {
+    if (full) {
+        for (RowBlock* b = cg->blocks; b != NULL; b = b->next) {
+            if (b->liveRows > 0) {
+                b->liveRows = 0;
+                b->replacedIn = snapshot->version;
+            }
+        }
+        cg->heldInts = 0;
+    }
+    int count = full ? snapshot->userLimit : cg->dirtyCount;
+    for (int i = 0; i < count; i++) {
+        int u = full ? i : cg->dirtyUsers[i];
+        RowBlock* previous = cg->rowBlock[u];
+        if (!full && previous != NULL && --previous->liveRows == 0) {
+            previous->replacedIn = snapshot->version;
+            cg->heldInts -= previous->size;
+        }
+        cg->rowBlock[u] = (snapshot->rowLength[u] > 0) ? block : NULL;
+        if (cg->rowBlock[u] != NULL) block->liveRows++;
+    }
+    for (int i = 0; i < cg->dirtyCount; i++) {
+        cg->dirtyMark[cg->dirtyUsers[i]] = false;
+    }
+    cg->dirtyCount = 0;
+
+    if (block != NULL) {
+        block->next = cg->blocks;
+        cg->blocks = block;
+        cg->heldInts += block->size;
+    }
+}
+// ºиĶһҪ¸Ƶû
+void markDirtyUser(ConcurrentGraph* cg, int userId) {
+    if (cg->dirtyMark[userId]) return;
+    cg->dirtyMark[userId] = true;
+    cg->dirtyUsers[cg->dirtyCount++] = userId;
+}
+// ͷŴͷѾûжߵǼǵĿգͷֻͷŵĿջõĿ
+void reclaimSnapshots(ConcurrentGraph* cg) {
+    ConcurrentSnapshot** link = &cg->retired;
+    while (*link != NULL) {
+        ConcurrentSnapshot* snapshot = *link;
+        bool inUse = false;
+        for (int i = 0; i < MAX_READER_THREADS && !inUse; i++) {
+            inUse = atomic_load(&cg->hazards[i]) == snapshot;
+        }
+        if (inUse) {
+            link = &snapshot->nextRetired;
+        } else {
+            *link = snapshot->nextRetired;
+            freeConcurrentSnapshot(snapshot);
+        }
+    }
+
+    // ڰ汾replacedIn滻Ŀȫͷźû
+    long long oldest = atomic_load(&cg->current)->version;
+    for (ConcurrentSnapshot* snapshot = cg->retired; snapshot != NULL; snapshot = snapshot->nextRetired) {
+        if (snapshot->version < oldest) oldest = snapshot->version;
+    }
+    RowBlock** blockLink = &cg->blocks;
+    while (*blockLink != NULL) {
+        RowBlock* block = *blockLink;
+        if (block->liveRows == 0 && block->replacedIn <= oldest) {
+            *blockLink = block->next;
+            free(block);
+        } else {
+            blockLink = &block->next;
+        }
+    }
+}
+// һддͼɲ¿գɿշͷڴ治ûܷʱ0
+// countMAX_PUBLISH_BATCHƵcountȣηʱ
+int publishMutations(ConcurrentGraph* cg, const EdgeMutation* batch, int count) {
+    for (int i = 0; i < count; i++) {
+        if (batch[i].add) {
+            insertFriendship(cg->graph, batch[i].userId1, batch[i].userId2);
+        } else {
+            deleteFriendship(cg->graph, batch[i].userId1, batch[i].userId2);
+        }
+        markDirtyUser(cg, batch[i].userId1);
+        markDirtyUser(cg, batch[i].userId2);
+    }
+
+    // ɿвõĿռ䳬ЧݵһʱûID¸һЩûĶУ
+    // ƵǸĶһ֮ǰľɿȫʹãռõĿռ䲻Чݵļ
+    ConcurrentSnapshot* old = atomic_load(&cg->current);
+    long long liveInts = 2LL * cg->graph->edgeSet.count;
+    if (cg->heldInts > liveInts + liveInts / 2 + old->userLimit) {
+        int compact = 2 * cg->dirtyCount;
+        if (compact < MIN_COMPACT_ROWS) compact = MIN_COMPACT_ROWS;
+        for (int k = 0; k < compact && cg->dirtyCount < old->userLimit; k++) {
+            if (cg->compactCursor >= old->userLimit) cg->compactCursor = 0;
+            markDirtyUser(cg, cg->compactCursor++);
+        }
+    }
+
+    RowBlock* block = NULL;
+    ConcurrentSnapshot* snapshot = buildConcurrentSnapshot(cg, old, false, &block);
+    if (snapshot == NULL) {
+        // ڴ治ʱдѾͼУĶûһɹʱһɼ
+        printf("ڴʧܣ\n");
+        return 0;
+    }
+    adoptRowBlock(cg, snapshot, block, false);
+    atomic_store(&cg->current, snapshot);
+    old->nextRetired = cg->retired;
+    cg->retired = old;
+    reclaimSnapshots(cg);
+    cg->publishCount++;
+    return 1;
+}
+// ¼һηӳ٣batchедͬǰʧµģfinishʱ̿ɼ
+void recordStaleness(ConcurrentGraph* cg, const EdgeMutation* batch, int count, long long finish) {
+    long long bound = cg->maxStalenessMs * 1000000LL;
+    if (cg->unpublishedCount > 0) {
+        long long staleness = finish - cg->unpublishedNanos;
+        cg->visibleWrites += cg->unpublishedCount;
+        cg->totalStalenessNanos += staleness * cg->unpublishedCount;  // һ
+        if (staleness > bound) cg->lateWrites += cg->unpublishedCount;
+        if (staleness > cg->maxStalenessNanos) cg->maxStalenessNanos = staleness;
+        cg->unpublishedCount = 0;
+        cg->unpublishedNanos = 0;
+    }
+    for (int i = 0; i < count; i++) {
+        long long staleness = finish - batch[i].queuedNanos;
+        cg->totalStalenessNanos += staleness;
+        if (staleness > bound) cg->lateWrites++;
+        if (staleness > cg->maxStalenessNanos) cg->maxStalenessNanos = staleness;
+    }
+    cg->visibleWrites += count;
+}
+// ϲ̣߳ȵܹһдĿӳٵһ룬ȡУּκϲ
+int mergeThreadMain(void* arg) {
+    ConcurrentGraph* cg = (ConcurrentGraph*)arg;
+    EdgeMutation* batch = NULL;
+    int batchCapacity = 0;
+
+    mtx_lock(&cg->queueLock);
+    while (1) {
+        while (!cg->stopping && !cg->flushRequested && cg->queueCount < cg->queueLimit) {
+            if (cg->queueCount == 0) {
+                cnd_wait(&cg->queueReady, &cg->queueLock);
+                continue;
+            }
+            // ֹʱԤʱĿӳٵһ룬һηʱʱԤ
+            long long bound = cg->maxStalenessMs * 1000000LL;
+            long long reserve = (cg->lastBuildNanos > bound / 2) ? cg->lastBuildNanos : bound / 2;
+            long long deadline = cg->firstQueuedNanos + bound - reserve;
+            if (currentNanos() >= deadline) break;
+            struct timespec until;
+            until.tv_sec = deadline / 1000000000LL;
+            until.tv_nsec = deadline % 1000000000LL;
+            cnd_timedwait(&cg->queueReady, &cg->queueLock, &until);
+        }
+        if (cg->queueCount == 0 && cg->stopping) break;
+
+        // Уд߼һӣϲ̴߳ȡһ
+        EdgeMutation* taken = cg->queue;
+        int takenCount = cg->queueCount;
+        int takenCapacity = cg->queueCapacity;
+        cg->queue = batch;
+        cg->queueCapacity = batchCapacity;
+        cg->queueCount = 0;
+        batch = taken;
+        batchCapacity = takenCapacity;
+        long long target = cg->queuedTotal;
+        cg->flushRequested = false;
+        cnd_broadcast(&cg->queueApplied);  // ѿճѵȴд
+        mtx_unlock(&cg->queueLock);
+
+        // ּηӵȿɼһηΪȡ̫ʱ
+        long long batchStart = currentNanos();
+        for (int done = 0; done < takenCount; ) {
+            int count = takenCount - done;
+            if (count > MAX_PUBLISH_BATCH) count = MAX_PUBLISH_BATCH;
+            long long start = currentNanos();
+            int published = publishMutations(cg, batch + done, count);
+            long long finish = currentNanos();
+            cg->lastBuildNanos = finish - start;
+            if (published) {
+                recordStaleness(cg, batch + done, count, finish);
+            } else {
+                if (cg->unpublishedCount == 0) cg->unpublishedNanos = batch[done].queuedNanos;
+                cg->unpublishedCount += count;
+            }
+            done += count;
+        }
+        int queueLimit = cg->mergeBatch;
+        if (takenCount > 0) {
+            // ķٶȣдȨֻмСѹƫ
+            // Ŀӳٵķ֮һܷϲ̷ֲ߳CPUʱ
+            cg->recentPublishNanos = cg->recentPublishNanos * 3 / 4 + (currentNanos() - batchStart);
+            cg->recentPublishWrites = cg->recentPublishWrites * 3 / 4 + takenCount;
+            long long affordable = cg->maxStalenessMs * 250000LL * cg->recentPublishWrites /
+                                   (cg->recentPublishNanos > 0 ? cg->recentPublishNanos : 1);
+            if (affordable < queueLimit) queueLimit = (affordable > MIN_QUEUE_LIMIT) ? (int)affordable : MIN_QUEUE_LIMIT;
+        }
+
+        mtx_lock(&cg->queueLock);
+        cg->appliedTotal = target;
+        cg->queueLimit = queueLimit;
+        cnd_broadcast(&cg->queueApplied);
+    }
+    mtx_unlock(&cg->queueLock);
+    free(batch);
+    return 0;
+}
+// ģʽͼϲֱ̹߳stopConcurrentGraph黹ڼ䲻ֱ޸ͼ
+// maxStalenessMsдɼĿӳ٣mergeBatchܹϲ<=0ʱĬֵ
+ConcurrentGraph* startConcurrentGraph(Graph* graph, int maxStalenessMs, int mergeBatch) {
+    ConcurrentGraph* cg = (ConcurrentGraph*)calloc(1, sizeof(ConcurrentGraph));
+    if (cg == NULL) {
+        printf("ڴʧܣ\n");
+        return NULL;
+    }
+    int userLimit = (graph->nextId > 0) ? graph->nextId : 1;
+    cg->graph = graph;
+    cg->maxStalenessMs = (maxStalenessMs > 0) ? maxStalenessMs : DEFAULT_MAX_STALENESS_MS;
+    cg->mergeBatch = (mergeBatch > 0) ? mergeBatch : DEFAULT_MERGE_BATCH;
+    cg->queueLimit = cg->mergeBatch;
+    cg->queue = (EdgeMutation*)malloc(INIT_MUTATION_CAPACITY * sizeof(EdgeMutation));
+    cg->queueCapacity = INIT_MUTATION_CAPACITY;
+    cg->rowBlock = (RowBlock**)calloc(userLimit, sizeof(RowBlock*));
+    cg->dirtyUsers = (int*)malloc(userLimit * sizeof(int));
+    cg->dirtyMark = (bool*)calloc(userLimit, sizeof(bool));
+    ConcurrentSnapshot* first = NULL;
+    if (cg->queue != NULL && cg->rowBlock != NULL && cg->dirtyUsers != NULL && cg->dirtyMark != NULL) {
+        RowBlock* block = NULL;
+        first = buildConcurrentSnapshot(cg, NULL, true, &block);
+        if (first != NULL) adoptRowBlock(cg, first, block, true);
+    }
+    if (first == NULL) {
+        printf("ڴʧܣ\n");
+        free(cg->queue);
+        free(cg->rowBlock);
+        free(cg->dirtyUsers);
+        free(cg->dirtyMark);
+        free(cg);
+        return NULL;
+    }
+    atomic_init(&cg->current, first);
+    for (int i = 0; i < MAX_READER_THREADS; i++) {
+        atomic_init(&cg->hazards[i], NULL);
+        atomic_init(&cg->readerUsed[i], false);
+    }
+
+    bool lockReady = mtx_init(&cg->queueLock, mtx_plain) == thrd_success;
+    bool readyReady = cnd_init(&cg->queueReady) == thrd_success;
+    bool appliedReady = cnd_init(&cg->queueApplied) == thrd_success;
+    if (lockReady && readyReady && appliedReady &&
+        thrd_create(&cg->mergeThread, mergeThreadMain, cg) == thrd_success) {
+        return cg;
+    }
+
+    printf("ϲ߳ʧܣ\n");
+    if (lockReady) mtx_destroy(&cg->queueLock);
+    if (readyReady) cnd_destroy(&cg->queueReady);
+    if (appliedReady) cnd_destroy(&cg->queueApplied);
+    freeConcurrentSnapshot(first);
+    free(cg->blocks);  // һֻһ
+    free(cg->queue);
+    free(cg->rowBlock);
+    free(cg->dirtyUsers);
+    free(cg->dirtyMark);
+    free(cg);
+    return NULL;
+}
+// ֹͣģʽϲʣдϲ̣߳ͷпպͿ飬黹ͼ
+// ǰж̶߳ӦѾͷſղȡǼ
+Graph* stopConcurrentGraph(ConcurrentGraph* cg) {
+    mtx_lock(&cg->queueLock);
+    cg->stopping = true;
+    cnd_signal(&cg->queueReady);
+    mtx_unlock(&cg->queueLock);
+    thrd_join(cg->mergeThread, NULL);
+
+    freeConcurrentSnapshot(atomic_load(&cg->current));
+    while (cg->retired != NULL) {
+        ConcurrentSnapshot* next = cg->retired->nextRetired;
+        freeConcurrentSnapshot(cg->retired);
+        cg->retired = next;
+    }
+    while (cg->blocks != NULL) {
+        RowBlock* next = cg->blocks->next;
+        free(cg->blocks);
+        cg->blocks = next;
+    }
+    mtx_destroy(&cg->queueLock);
+    cnd_destroy(&cg->queueReady);
+    cnd_destroy(&cg->queueApplied);
+    free(cg->queue);
+    free(cg->rowBlock);
+    free(cg->dirtyUsers);
+    free(cg->dirtyMark);
+
+    Graph* graph = cg->graph;
+    free(cg);
+    return graph;
+}
+// һдУʾɹ1ûЧ0ڴ治㷵-1
+int enqueueMutation(ConcurrentGraph* cg, int userId1, int userId2, bool add) {
+    if (!isValidUser(cg->graph, userId1) || !isValidUser(cg->graph, userId2) || userId1 == userId2) {
+        return 0;
+    }
+
+    mtx_lock(&cg->queueLock);
+    // ܵޣдѾĿӳٵһ뻹ûȡߣϲ߳æʱȴ
+    // д̫ҲöԽԽࣻʱֻֻкϲ߳ȡ߶вŻȴ
+    long long halfBound = cg->maxStalenessMs * 500000LL;
+    while (!cg->stopping &&
+           (cg->queueCount >= cg->queueLimit ||
+            (cg->queueCount > 0 && currentNanos() - cg->firstQueuedNanos >= halfBound))) {
+        cnd_signal(&cg->queueReady);
+        cnd_wait(&cg->queueApplied, &cg->queueLock);
+    }
+    if (cg->queueCount >= cg->queueCapacity) {
+        int newCapacity = (cg->queueCapacity == 0) ? INIT_MUTATION_CAPACITY : cg->queueCapacity * 2;
+        EdgeMutation* newQueue = (EdgeMutation*)realloc(cg->queue, newCapacity * sizeof(EdgeMutation));
+        if (newQueue == NULL) {
+            mtx_unlock(&cg->queueLock);
+            return -1;
+        }
+        cg->queue = newQueue;
+        cg->queueCapacity = newCapacity;
+    }
+    long long now = currentNanos();
+    if (cg->queueCount == 0) cg->firstQueuedNanos = now;
+    cg->queue[cg->queueCount].userId1 = userId1;
+    cg->queue[cg->queueCount].userId2 = userId2;
+    cg->queue[cg->queueCount].add = add;
+    cg->queue[cg->queueCount].queuedNanos = now;
+    cg->queueCount++;
+    cg->queuedTotal++;
+    // һдúϲ߳̿ʼʱܹһʱϲ
+    if (cg->queueCount == 1 || cg->queueCount >= cg->queueLimit) {
+        cnd_signal(&cg->queueReady);
+    }
+    mtx_unlock(&cg->queueLock);
+    return 1;
+}
+// ģʽ¼ӺѣкأĿmaxStalenessMsڿɼ
+int concurrentAddFriend(ConcurrentGraph* cg, int userId1, int userId2) {
+    return enqueueMutation(cg, userId1, userId2, true);
+}
+// ģʽɾ
+int concurrentRemoveFriend(ConcurrentGraph* cg, int userId1, int userId2) {
+    return enqueueMutation(cg, userId1, userId2, false);
+}
+// ȴǰӵдȫ֮ȡõĿһܶЩд
+void flushConcurrentGraph(ConcurrentGraph* cg) {
+    mtx_lock(&cg->queueLock);
+    long long target = cg->queuedTotal;
+    if (cg->appliedTotal < target) {
+        cg->flushRequested = true;
+        cnd_signal(&cg->queueReady);
+    }
+    while (cg->appliedTotal < target) {
+        cnd_wait(&cg->queueApplied, &cg->queueLock);
+    }
+    mtx_unlock(&cg->queueLock);
+}
+// ̵߳ǼǣcgռһеĵǼλãѾǼǹֱӷ1λöռʱ0
+// ߳̽ǰҪunregisterReader黹λã֮߳̿
+int registerReader(ConcurrentGraph* cg) {
+    if (readerGraph == cg && readerSlot >= 0) return 1;
+    for (int i = 0; i < MAX_READER_THREADS; i++) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&cg->readerUsed[i], &expected, true)) {
+            readerGraph = cg;
+            readerSlot = i;
+            return 1;
+        }
+    }
+    return 0;
+}
+// ߳ȡǼǣеĿղ黹Ǽλ
+void unregisterReader(ConcurrentGraph* cg) {
+    if (readerGraph != cg || readerSlot < 0) return;
+    atomic_store(&cg->hazards[readerSlot], NULL);
+    atomic_store(&cg->readerUsed[readerSlot], false);
+    readerGraph = NULL;
+    readerSlot = -1;
+}
+// ȡõǰգȵǼȷϿûб滻Ǽڼϲ̲߳ͷ
+// releaseSnapshotÿ߳ͬһʱֻһ
+// ûǼǵ̵߳һεʱԶǼǣͬʱǼǵĶ̳߳ʱNULL
+const ConcurrentSnapshot* acquireSnapshot(ConcurrentGraph* cg) {
+    if (!registerReader(cg)) return NULL;
+
+    ConcurrentSnapshot* snapshot;
+    do {
+        snapshot = atomic_load(&cg->current);
+        atomic_store(&cg->hazards[readerSlot], snapshot);
+    } while (snapshot != atomic_load(&cg->current));
+    return snapshot;
+}
+// պȡǼ
+void releaseSnapshot(ConcurrentGraph* cg) {
+    if (readerGraph == cg && readerSlot >= 0) {
+        atomic_store(&cg->hazards[readerSlot], NULL);
+    }
+}
+// ڿжǷǺѣĺжֲң
+bool snapshotAreFriends(const ConcurrentSnapshot* snapshot, int userId1, int userId2) {
+    if (userId1 <= 0 || userId1 >= snapshot->userLimit) return false;
+
+    const int* row = snapshot->rows[userId1];
+    int low = 0;
+    int high = snapshot->rowLength[userId1] - 1;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        if (row[mid] == userId2) return true;
+        if (row[mid] < userId2) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return false;
+}
+// ûĺ
+int snapshotFriendCount(const ConcurrentSnapshot* snapshot, int userId) {
+    if (userId <= 0 || userId >= snapshot->userLimit) return 0;
+    return snapshot->rowLength[userId];
+}
+// ڿ֮̾루BFSͨ-1
+int snapshotDistance(const ConcurrentSnapshot* snapshot, int from, int to) {
+    if (from <= 0 || from >= snapshot->userLimit || to <= 0 || to >= snapshot->userLimit) return -1;
+    if (from == to) return 0;
+
+    SearchScratch* scratch = reserveSearchScratch(snapshot->userLimit);
+    if (scratch == NULL) return -1;
+    beginVisit(scratch);
+    unsigned int epoch = scratch->epoch;
+
+    int head = 0, tail = 0, distance = 0;
+    scratch->queue[tail++] = from;
+    scratch->visitMark[from] = epoch;
+    while (head < tail) {
+        distance++;
+        int levelEnd = tail;
+        while (head < levelEnd) {
+            int u = scratch->queue[head++];
+            const int* row = snapshot->rows[u];
+            for (int i = 0; i < snapshot->rowLength[u]; i++) {
+                int v = row[i];
+                if (v == to) return distance;
+                if (scratch->visitMark[v] == epoch) continue;
+                scratch->visitMark[v] = epoch;
+                scratch->queue[tail++] = v;
+            }
+        }
+    }
+    return -1;
+}
+#endif
+// ʾû
+void displayAllUsers(Graph* graph) {
+    if (graph->userCount == 0) {
+        printf("û\n");
+        return;
+    }
+
+    printf("\n========== ûб ==========\n");
+    printf("%-6s %-30s %-10s\n", "ID", "û", "");
+    printf("------------------------------------------------------------\n");
+
+    for (int i = 1; i < graph->nextId; i++) {
+        if (graph->users[i].exists) {
+            printf("%-6d %-30s %-10d\n", i, graph->users[i].name, getFriendCount(graph, i));
+        }
+    }
+    printf("================================\n\n");
+}
+// ʾûĺб
+void displayFriends(Graph* graph, int userId) {
+    if (!isValidUser(graph, userId)) {
+        printf("ûڣ\n");
+        return;
+    }
+
+    printf("\nû %d (%s) ĺб\n", userId, graph->users[userId].name);
+    FriendIterator it;
+    startFriendIterator(&it, graph, userId);
+    int friendId = nextFriend(&it);
+    if (friendId < 0) {
+        printf("  ޺\n");
+    }
+    for (; friendId >= 0; friendId = nextFriend(&it)) {
+        const EdgeAttr* attr = findEdgeAttr(graph, userId, friendId);
+        if (attr == NULL) {
+            printf("  - û %d: %s\n", friendId, graph->users[friendId].name);
+            continue;
+        }
+
+        printf("  - û %d: %sȨ %d %d ", friendId, graph->users[friendId].name,
+               attr->weight, attr->interactions);
+        if (attr->createdAt > 0) {
+            time_t createdAt = (time_t)attr->createdAt;
+            char date[32];
+            strftime(date, sizeof(date), "%Y-%m-%d", localtime(&createdAt));
+            printf("%s Ϊ", date);
+        }
+        printf("\n");
+    }
+    printf("\n");
+}
+// ʾûܵĺѣǰSTRONG_TIE_COUNTֱӶ
+void displayStrongestTies(Graph* graph, int userId) {
+    if (!isValidUser(graph, userId)) {
+        printf("ûڣ\n");
+        return;
+    }
+
+    printf("\nû %d (%s) ܵĺѣ\n", userId, graph->users[userId].name);
+    int count = (graph->strongTieCount == NULL) ? 0 : graph->strongTieCount[userId];
+    if (count == 0) {
+        printf("  ޻¼\n");
+    }
+    const StrongTie* ties = graph->strongTies + (long long)userId * STRONG_TIE_COUNT;
+    for (int i = 0; i < count; i++) {
+        printf("  %d. û %d: %s %d Σ\n", i + 1, ties[i].friendId,
+               graph->users[ties[i].friendId].name, ties[i].interactions);
+    }
+    printf("\n");
+}
+// ʾ·
+void displayPath(Graph* graph, int* path, int pathLength, int degree) {
+    if (degree < 0) {
+        printf("û֮䲻ɴ\n");
+        return;
+    }
+
+    printf("\n·%dȺѣ\n", degree);
+    for (int i = 0; i < pathLength; i++) {
+        printf("  û %d: %s", path[i], graph->users[path[i]].name);
+        if (i < pathLength - 1) {
+            printf("  ");
+        }
+    }
+    printf("\n\n");
+}
+// ʾȨ·
+void displayWeightedPath(Graph* graph, int* path, int pathLength, long long cost) {
+    if (cost < 0) {
+        printf("û֮䲻ɴ\n");
+        return;
+    }
+
+    printf("\nȨ·Ȩ %lld %d ȣ\n", cost, pathLength - 1);
+    for (int i = 0; i < pathLength; i++) {
+        printf("  û %d: %s", path[i], graph->users[path[i]].name);
+        if (i < pathLength - 1) {
+            printf("  ");
+        }
+    }
+    printf("\n\n");
+}
+// ˵
+void showMainMenu() {
+    printf("\n========== 罻ϵͳ ==========\n");
+    printf("1. û\n");
+    printf("2. Ӻѹϵ\n");
+    printf("3. ɾѹϵ\n");
+    printf("4. ʾû\n");
+    printf("5. 鿴б\n");
+    printf("6. ·Ⱥѣ\n");
+    printf("7. ҹͬ\n");
+    printf("8. Ƽ\n");
+    printf("9. Ȧ\n");
+    printf("10. ͳϢ\n");
+    printf("11. Ȧͳ\n");
+    printf("12. ͼ\n");
+    printf("13. ͼ\n");
+    printf("14. ѹϵб\n");
+    printf("15. Ӱָ\n");
+    printf("16. Ʋû\n");
+    printf("17. ɾû\n");
+    printf("18. Nڵĺ\n");
+    printf("19. ¼ѻ\n");
+    printf("20. úѹϵȨ\n");
+    printf("21. 鿴ܵĺ\n");
+    printf("22. ҼȨ·\n");
+    printf("23. ڲĺ\n");
+    printf("0. ˳\n");
+    printf("==================================\n");
+    printf("ѡ");
+}
+// ûϢ
+void inputUserInfo(char* name) {
+    printf("ûƣ");
+    fgets(name, MAX_NAME_LEN, stdin);
+    name[strcspn(name, "\n")] = 0;  // Ƴз
+}
+void inputFileName(char* fileName) {
+    printf("ļ");
+    fgets(fileName, MAX_FILE_NAME_LEN, stdin);
+    fileName[strcspn(fileName, "\n")] = 0;  // Ƴз
+}
+// ͳϢ
+void displayStatistics(Graph* graph) {
+    printf("\n========== ͳϢ ==========\n");
+    printf("û%d\n", graph->userCount);
+    printf("ѹϵ%d\n", graph->edgeSet.count);
+    if (graph->userCount > 0) {
+        // ûֻ飬ʺб
+        int userWithMaxFriends = 1;
+        while (!graph->users[userWithMaxFriends].exists ||
+               graph->degree[userWithMaxFriends] != graph->maxDegree) {
+            userWithMaxFriends++;
+        }
+        int minFriends = 0;
+        while (graph->degreeHistogram[minFriends] == 0) minFriends++;
+
+        printf("ƽ%.2f\n", 2.0f * graph->edgeSet.count / graph->userCount);
+        printf("%dû %d: %s\n",
+               graph->maxDegree, userWithMaxFriends, graph->users[userWithMaxFriends].name);
+        printf("ٺ%d\n", minFriends);
+
+        // ֲ0123-45-8ֶʾ
+        printf("ֲ\n");
+        for (int low = 0, high = 0; low <= graph->maxDegree; low = high + 1) {
+            high = (low <= 2) ? low : 2 * (low - 1);
+            int users = 0;
+            for (int d = low; d <= high && d <= graph->maxDegree; d++) {
+                users += graph->degreeHistogram[d];
+            }
+            if (users == 0) continue;
+            if (low == high) {
+                printf("  %dѣ%d \n", low, users);
+            } else {
+                printf("  %d-%dѣ%d \n", low, high, users);
+            }
+        }
+    }
+    printf("==============================\n\n");
+}
+// αxorshift64*ܲù̶ӱ֤ظ
+unsigned long long nextRandom(unsigned long long* state) {
+    unsigned long long x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 2685821657736338717ULL;
+}
+// ܲõĻصֻ
+bool countNeighbor(int userId, int distance, void* context) {
+    (void)userId;
+    (void)distance;
+    (void)context;
+    return true;
+}
+// ڽӱϵBFSɰ汾ʵ֣ÿβѯҪʼ飬ܶԱȣ
+// queuedistanceĳȲСuserCapacityؾ룬ɴﷵ-1
+int legacyShortestPath(AdjListNode** heads, int userCapacity, int fromUserId, int toUserId,
+                       int* queue, int* distance) {
+    int front = 0, rear = 0;
+    for (int i = 0; i < userCapacity; i++) {
+        distance[i] = -1;
+    }
+
+    queue[rear++] = fromUserId;
+    distance[fromUserId] = 0;
+    while (front < rear) {
+        int current = queue[front++];
+        if (current == toUserId) return distance[current];
+
+        for (AdjListNode* node = heads[current]; node != NULL; node = node->next) {
+            if (distance[node->userId] < 0) {
+                distance[node->userId] = distance[current] + 1;
+                queue[rear++] = node->userId;
+            }
+        }
+    }
+    return -1;
+}
+// ڽӱϵĹͬѣɰ汾ʵ֣ܶԱȣ
+int legacyCommonFriends(AdjListNode** heads, int userId1, int userId2) {
+    int count = 0;
+    for (AdjListNode* a = heads[userId1]; a != NULL; a = a->next) {
+        for (AdjListNode* b = heads[userId2]; b != NULL; b = b->next) {
+            if (a->userId == b->userId) {
+                count++;
+                break;
+            }
+        }
+    }
+    return count;
+}
+// ԭĹͬ㷨бȽϣO(d1 * d2)ܶԱ
+int countCommonFriendsNested(Graph* graph, int userId1, int userId2, int* friends1, int* friends2) {
+    int count1, count2, count = 0;
+    getFriends(graph, userId1, friends1, &count1);
+    getFriends(graph, userId2, friends2, &count2);
+    for (int i = 0; i < count1; i++) {
+        for (int j = 0; j < count2; j++) {
+            if (friends1[i] == friends2[j]) {
+                count++;
+                break;
+            }
+        }
+    }
+    return count;
+}
+// ܲԣͬһͼֱCSRִͬĲѯԱȺʱ
+// powerLaw0ʱͼԽûԽױϣ
+void runGraphBenchmark(int userCount, int avgDegree, int queries, int powerLaw) {
+    if (userCount <= 1) userCount = 1000;
+    int withLegacy = (userCount <= LEGACY_BENCH_LIMIT);
+
+    Graph* graph = initGraph();
+    if (graph == NULL) return;
+
+    char name[32];
+    clock_t start = clock();
+    for (int i = 0; i < userCount; i++) {
+        sprintf(name, "û%d", i + 1);
+        if (insertUser(graph, name) < 0) {
+            printf("ڴʧܣ\n");
+            freeGraph(graph);
+            return;
+        }
+    }
+    printf("\n========== ܲ ==========\n");
+    printf(" %d û%.3f \n", userCount, (double)(clock() - start) / CLOCKS_PER_SEC);
+
+    AdjListNode** heads = withLegacy ?
+        (AdjListNode**)calloc(graph->userCapacity, sizeof(AdjListNode*)) : NULL;
+
+    unsigned long long state = 88172645463325252ULL;
+    long long edgeTarget = (long long)userCount * avgDegree / 2;
+    // ӣкѹϵĶ˵ȡһѡеĸ
+    int* endpoints = powerLaw ? (int*)malloc(edgeTarget * 2 * sizeof(int)) : NULL;
+    int edges = 0;
+    start = clock();
+    for (long long i = 0; i < edgeTarget; i++) {
+        int u = 1 + (int)(nextRandom(&state) % userCount);
+        int v = 1 + (int)(nextRandom(&state) % userCount);
+        if (endpoints != NULL && edges > 0 && nextRandom(&state) % 4 != 0) {
+            v = endpoints[nextRandom(&state) % (edges * 2)];
+        }
+        if (u == v || insertFriendship(graph, u, v) != 1) continue;
+        if (endpoints != NULL) {
+            endpoints[edges * 2] = u;
+            endpoints[edges * 2 + 1] = v;
+        }
+        edges++;
+        if (heads == NULL) continue;
+
+        AdjListNode* node1 = createAdjListNode(v);
+        AdjListNode* node2 = createAdjListNode(u);
+        if (node1 == NULL || node2 == NULL) break;
+        node1->next = heads[u];
+        heads[u] = node1;
+        node2->next = heads[v];
+        heads[v] = node2;
+    }
+    mergePendingEdges(graph);
+    free(endpoints);
+    printf("ѹϵ %d%s%.3f \n", edges, powerLaw ? "ͼ" : "ͼ",
+           (double)(clock() - start) / CLOCKS_PER_SEC);
+
+    int* pairs = (int*)malloc(queries * 2 * sizeof(int));
+    int* path = (int*)malloc(graph->userCapacity * sizeof(int));
+    int* distance = withLegacy ? (int*)malloc(graph->userCapacity * sizeof(int)) : NULL;
+    if (pairs != NULL && path != NULL) {
+        for (int i = 0; i < queries * 2; i++) {
+            pairs[i] = 1 + (int)(nextRandom(&state) % userCount);
+        }
+
+        int pathLength;
+        long long checksum = 0, visited = 0;
+        SearchScratch* scratch = getSearchScratch(graph);
+        start = clock();
+        for (int i = 0; i < queries; i++) {
+            checksum += findShortestPath(graph, pairs[2 * i], pairs[2 * i + 1], path, &pathLength);
+            visited += scratch->visitedCount;
+        }
+        printf("· %d ΣCSR%.3f 룬У %lldƽ %lld û\n",
+               queries, (double)(clock() - start) / CLOCKS_PER_SEC, checksum, visited / queries);
+
+        checksum = 0;
+        visited = 0;
+        start = clock();
+        for (int i = 0; i < queries; i++) {
+            checksum += findShortestPathBidirectional(graph, pairs[2 * i], pairs[2 * i + 1],
+                                                      path, &pathLength, 0);
+            visited += scratch->visitedCount;
+        }
+        printf("· %d Σ˫BFS%.3f 룬У %lldƽ %lld û\n",
+               queries, (double)(clock() - start) / CLOCKS_PER_SEC, checksum, visited / queries);
+
+        PathQuery* batch = (PathQuery*)malloc(queries * sizeof(PathQuery));
+        if (batch != NULL) {
+            for (int i = 0; i < queries; i++) {
+                batch[i].from = pairs[2 * i];
+                batch[i].to = pairs[2 * i + 1];
+            }
+            checksum = 0;
+            start = clock();
+            findShortestDistancesBatch(graph, batch, queries);
+            double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+            for (int i = 0; i < queries; i++) {
+                checksum += batch[i].distance;
+            }
+            printf("· %d ΣԴBFS%.3f 루CPUʱ䣩У %lldÿ %.0f \n",
+                   queries, seconds, checksum, queries / (seconds > 0 ? seconds : 1e-9));
+            free(batch);
+        }
+
+        // 6ͨѸǼͼࣩܲѯΪ1/10
+        int hopCounts[3] = {2, 3, 6};
+        for (int h = 0; h < 3; h++) {
+            int hops = hopCounts[h];
+            int hopQueries = (hops < 6 || queries < 10) ? queries : queries / 10;
+            for (int mode = 0; mode < 2; mode++) {
+                checksum = 0;
+                start = clock();
+                for (int i = 0; i < hopQueries; i++) {
+                    checksum += expandNeighborhood(graph, pairs[2 * i], hops, -1,
+                                                   countNeighbor, NULL, mode == 1);
+                }
+                printf("%dں %d Σ%s%.3f 룬ƽ %lld \n", hops, hopQueries,
+                       mode == 1 ? "ܲԵ" : "Զ",
+                       (double)(clock() - start) / CLOCKS_PER_SEC, checksum / hopQueries);
+            }
+        }
+
+        if (heads != NULL && distance != NULL) {
+            checksum = 0;
+            start = clock();
+            for (int i = 0; i < queries; i++) {
+                checksum += legacyShortestPath(heads, graph->userCapacity,
+                                               pairs[2 * i], pairs[2 * i + 1], path, distance);
+            }
+            printf("· %d Σ%.3f 룬У %lld\n",
+                   queries, (double)(clock() - start) / CLOCKS_PER_SEC, checksum);
+        }
+
+        int* common = path;  // ͬѲᳬûֱӸpath
+        int commonCount;
+        checksum = 0;
+        start = clock();
+        for (int i = 0; i < queries; i++) {
+            findCommonFriends(graph, pairs[2 * i], pairs[2 * i + 1], common, &commonCount);
+            checksum += commonCount;
+        }
+        printf("ͬ %d ΣCSR%.3f 룬У %lld\n",
+               queries, (double)(clock() - start) / CLOCKS_PER_SEC, checksum);
+
+        if (heads != NULL) {
+            checksum = 0;
+            start = clock();
+            for (int i = 0; i < queries; i++) {
+                checksum += legacyCommonFriends(heads, pairs[2 * i], pairs[2 * i + 1]);
+            }
+            printf("ͬ %d Σ%.3f 룬У %lld\n",
+                   queries, (double)(clock() - start) / CLOCKS_PER_SEC, checksum);
+        }
+
+        // û֮Ĺͬ
+        int hub1 = 1, hub2 = 2;
+        for (int u = 1; u < graph->nextId; u++) {
+            int degree = getFriendCount(graph, u);
+            if (degree > getFriendCount(graph, hub1)) {
+                hub2 = hub1;
+                hub1 = u;
+            } else if (u != hub1 && degree > getFriendCount(graph, hub2)) {
+                hub2 = u;
+            }
+        }
+        int* friends2 = (int*)malloc(graph->userCapacity * sizeof(int));
+        if (friends2 != NULL) {
+            int hubQueries = 10;
+            checksum = 0;
+            start = clock();
+            for (int i = 0; i < hubQueries; i++) {
+                checksum += countCommonFriendsNested(graph, hub1, hub2, common, friends2);
+            }
+            double nestedSeconds = (double)(clock() - start) / CLOCKS_PER_SEC / hubQueries;
+            printf("Vͬѣ %d  %dȽϣÿ %.6f 룬ͬ %lld\n",
+                   getFriendCount(graph, hub1), getFriendCount(graph, hub2),
+                   nestedSeconds, checksum / hubQueries);
+
+            hubQueries = 10000;
+            checksum = 0;
+            start = clock();
+            for (int i = 0; i < hubQueries; i++) {
+                findCommonFriends(graph, hub1, hub2, common, &commonCount);
+                checksum += commonCount;
+            }
+            printf("Vͬѣ򽻼ÿ %.6f 룬ͬ %lld\n",
+                   (double)(clock() - start) / CLOCKS_PER_SEC / hubQueries, checksum / hubQueries);
+            free(friends2);
+        }
+
+        checksum = 0;
+        start = clock();
+        for (int i = 0; i < queries; i++) {
+            recommendFriends(graph, pairs[2 * i], common, &commonCount);
+            checksum += commonCount;
+        }
+        printf("Ƽ %d Σȫѵĺѣ%.3f 룬ƽ %lld \n",
+               queries, (double)(clock() - start) / CLOCKS_PER_SEC, checksum / queries);
+
+        Recommendation top[DEFAULT_RECOMMEND_COUNT];
+        start = clock();
+        for (int i = 0; i < queries; i++) {
+            recommendTopFriends(graph, pairs[2 * i], top, DEFAULT_RECOMMEND_COUNT);
+        }
+        printf("Ƽ %d ΣAdamic-Adarǰ%d%.3f \n",
+               queries, DEFAULT_RECOMMEND_COUNT, (double)(clock() - start) / CLOCKS_PER_SEC);
+
+        Recommendation* all = (Recommendation*)malloc(
+            (long long)graph->nextId * DEFAULT_RECOMMEND_COUNT * sizeof(Recommendation));
+        int* allCounts = (int*)malloc(graph->nextId * sizeof(int));
+        if (all != NULL && allCounts != NULL) {
+            start = clock();
+            recommendForAllUsers(graph, DEFAULT_RECOMMEND_COUNT, all, allCounts);
+            double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+            printf("Ƽ %d û%.3f 루CPUʱ䣩\n", userCount, seconds);
+        }
+        free(all);
+        free(allCounts);
+
+        // ȦûBFS / 鼯 / ǩ
+        int* componentId = (int*)malloc(graph->nextId * sizeof(int));
+        int* circleSizes = (int*)malloc(graph->nextId * sizeof(int));
+        bool* seen = (bool*)calloc(graph->nextId, sizeof(bool));
+        if (componentId != NULL && circleSizes != NULL && seen != NULL) {
+            int circleCount = 0, count;
+            start = clock();
+            for (int u = 1; u < graph->nextId; u++) {
+                if (seen[u]) continue;
+                findConnectedComponent(graph, u, common, &count);
+                for (int i = 0; i < count; i++) seen[common[i]] = true;
+                circleCount++;
+            }
+            printf("ȫȦBFS%.3f 룬 %d \n",
+                   (double)(clock() - start) / CLOCKS_PER_SEC, circleCount);
+
+            start = clock();
+            circleCount = labelFriendCircles(graph, componentId, circleSizes, false);
+            printf("ȫȦ鼯Ӻʱϲ%.3f 룬 %d \n",
+                   (double)(clock() - start) / CLOCKS_PER_SEC, circleCount);
+
+            start = clock();
+            rebuildCircles(graph);
+            printf("ؽ鼯%.3f \n", (double)(clock() - start) / CLOCKS_PER_SEC);
+
+            start = clock();
+            circleCount = labelFriendCircles(graph, componentId, circleSizes, true);
+            printf("ȫȦǩ%.3f 루CPUʱ䣩 %d \n",
+                   (double)(clock() - start) / CLOCKS_PER_SEC, circleCount);
+        }
+        free(componentId);
+        free(circleSizes);
+        free(seen);
+    }
+    printf("==============================\n\n");
+
+    free(pairs);
+    free(path);
+    free(distance);
+    for (int i = 0; heads != NULL && i < graph->userCapacity; i++) {
+        while (heads[i] != NULL) {
+            AdjListNode* temp = heads[i];
+            heads[i] = temp->next;
+            free(temp);
+        }
+    }
+    free(heads);
+    freeGraph(graph);
+    freeSearchScratch();
+}
+// ѹϵɾܲԣedgeCountѹϵƽÿ64ѣ
+// ٱȽϹϣϺͺбжϷʽɾ
+void runEdgeBenchmark(long long edgeCount) {
+    if (edgeCount <= 0) edgeCount = 100000000;
+    int userCount = (int)(edgeCount * 2 / 64);
+    if (userCount < 100) userCount = 100;
+
+    Graph* graph = initGraph();
+    if (graph == NULL) return;
+
+    char name[32];
+    for (int i = 0; i < userCount; i++) {
+        sprintf(name, "û%d", i + 1);
+        if (insertUser(graph, name) < 0) {
+            printf("ڴʧܣ\n");
+            freeGraph(graph);
+            return;
+        }
+    }
+
+    printf("\n========== ѹϵܲ ==========\n");
+    unsigned long long state = 88172645463325252ULL;
+    long long edges = 0, attempts = 0;
+    clock_t start = clock();
+    while (edges < edgeCount) {
+        int u = 1 + (int)(nextRandom(&state) % userCount);
+        int v = 1 + (int)(nextRandom(&state) % userCount);
+        attempts++;
+        if (u == v) continue;
+        int result = insertFriendship(graph, u, v);
+        if (result < 0) {
+            printf("ڴʧܣѽ %lld ѹϵ\n", edges);
+            break;
+        }
+        edges += result;
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("%d û %lld ѹϵ %lld Σ%.3f 룬ÿ %.0f \n",
+           userCount, edges, attempts, seconds, attempts / (seconds > 0 ? seconds : 1e-9));
+    printf("ϣ %d λռ %.1f MB\n", 1 << graph->edgeSet.bits,
+           (double)(8LL << graph->edgeSet.bits) / (1024 * 1024));
+
+    // һѯеĺѹϵȡĳ˵ĳѣһ
+    int queries = 1000000;
+    int* pairs = (int*)malloc(queries * 2 * sizeof(int));
+    if (pairs != NULL) {
+        for (int i = 0; i < queries; i++) {
+            int u = 1 + (int)(nextRandom(&state) % userCount);
+            int v = 1 + (int)(nextRandom(&state) % userCount);
+            if (i % 2 == 0 && getFriendCount(graph, u) > 0) {
+                FriendIterator it;
+                startFriendIterator(&it, graph, u);
+                v = nextFriend(&it);
+            }
+            pairs[2 * i] = u;
+            pairs[2 * i + 1] = v;
+        }
+
+        long long found = 0;
+        start = clock();
+        for (int i = 0; i < queries; i++) {
+            found += areFriends(graph, pairs[2 * i], pairs[2 * i + 1]);
+        }
+        printf("жϺ %d Σϣϣ%.3f 룬Ǻ %lld \n",
+               queries, (double)(clock() - start) / CLOCKS_PER_SEC, found);
+
+        found = 0;
+        start = clock();
+        for (int i = 0; i < queries; i++) {
+            found += areFriendsInRows(graph, pairs[2 * i], pairs[2 * i + 1]);
+        }
+        printf("жϺ %d Σб%.3f 룬Ǻ %lld \n",
+               queries, (double)(clock() - start) / CLOCKS_PER_SEC, found);
+
+        // ɾеĺѹϵټӻ
+        long long changed = 0;
+        start = clock();
+        for (int i = 0; i < queries; i += 2) {
+            if (deleteFriendship(graph, pairs[2 * i], pairs[2 * i + 1])) changed++;
+        }
+        for (int i = 0; i < queries; i += 2) {
+            if (pairs[2 * i] != pairs[2 * i + 1] &&
+                insertFriendship(graph, pairs[2 * i], pairs[2 * i + 1]) == 1) changed++;
+        }
+        printf("ɾӺѹϵ %lld Σ%.3f \n",
+               changed, (double)(clock() - start) / CLOCKS_PER_SEC);
+        free(pairs);
+    }
+    printf("======================================\n\n");
+    freeGraph(graph);
+}
+// ܲԣedgeCountѹϵдıͶļֱ룬
+// ٱͼղ룬ɾļ
+void runLoadBenchmark(long long edgeCount) {
+    if (edgeCount <= 0) edgeCount = 10000000;
+    int userCount = (int)(edgeCount * 2 / 64);
+    if (userCount < 100) userCount = 100;
+    const char* textFile = "bench_edges.txt";
+    const char* binaryFile = "bench_edges.bin";
+    const char* snapshotFile = "bench_graph.snap";
+
+    FILE* text = fopen(textFile, "w");
+    FILE* binary = fopen(binaryFile, "wb");
+    if (text == NULL || binary == NULL) {
+        printf("޷ļ\n");
+        if (text != NULL) fclose(text);
+        if (binary != NULL) fclose(binary);
+        return;
+    }
+
+    printf("\n========== ܲ ==========\n");
+    unsigned long long state = 88172645463325252ULL;
+    clock_t start = clock();
+    fprintf(text, "# %d û%lld ѹϵ\n", userCount, edgeCount);
+    for (long long i = 0; i < edgeCount; i++) {
+        int pair[2];
+        pair[0] = 1 + (int)(nextRandom(&state) % userCount);
+        pair[1] = 1 + (int)(nextRandom(&state) % userCount);
+        fprintf(text, "%d %d\n", pair[0], pair[1]);
+        fwrite(pair, sizeof(int), 2, binary);
+    }
+    fclose(text);
+    fclose(binary);
+    printf(" %lld ѹϵĲļ%.3f \n",
+           edgeCount, (double)(clock() - start) / CLOCKS_PER_SEC);
+
+    start = clock();
+    Graph* graph = loadEdgeList(textFile, false);
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    if (graph != NULL) {
+        printf("ıʽ%.3f 룬%d û%d ѹϵÿ %.0f \n", seconds,
+               graph->userCount, graph->edgeSet.count, edgeCount / (seconds > 0 ? seconds : 1e-9));
+        freeGraph(graph);
+    }
+
+    start = clock();
+    graph = loadEdgeList(binaryFile, true);
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    if (graph != NULL) {
+        printf("Ƹʽ%.3f 룬%d û%d ѹϵÿ %.0f \n", seconds,
+               graph->userCount, graph->edgeSet.count, edgeCount / (seconds > 0 ? seconds : 1e-9));
+
+        start = clock();
+        int saved = saveGraphSnapshot(graph, snapshotFile);
+        printf("ͼգ%.3f \n", (double)(clock() - start) / CLOCKS_PER_SEC);
+        int edges = graph->edgeSet.count;
+        freeGraph(graph);
+
+        if (saved) {
+            start = clock();
+            graph = loadGraphSnapshot(snapshotFile);
+            if (graph != NULL) {
+                printf("ͼգ%.3f 룬%d ѹϵ%s\n",
+                       (double)(clock() - start) / CLOCKS_PER_SEC, graph->edgeSet.count,
+                       graph->edgeSet.count == edges ? "" : "뵼һ£");
+                freeGraph(graph);
+            }
+        }
+    }
+    printf("==================================\n\n");
+
+    remove(textFile);
+    remove(binaryFile);
+    remove(snapshotFile);
+}
+// ûɾܲԣuserCountûƽ8ѣƲҡǰ׺ҡɾû
+void runUserBenchmark(int userCount) {
+    if (userCount <= 0) userCount = 1000000;
+    Graph* graph = initGraph();
+    if (graph == NULL) return;
+
+    printf("\n========== ûɾܲ ==========\n");
+    char name[32];
+    clock_t start = clock();
+    for (int i = 0; i < userCount; i++) {
+        sprintf(name, "û%d", i + 1);
+        if (insertUser(graph, name) < 0) {
+            printf("ڴʧܣ\n");
+            freeGraph(graph);
+            return;
+        }
+    }
+    printf(" %d û%.3f \n", userCount, (double)(clock() - start) / CLOCKS_PER_SEC);
+
+    unsigned long long state = 88172645463325252ULL;
+    for (long long i = 0; i < (long long)userCount * 4; i++) {
+        int u = 1 + (int)(nextRandom(&state) % userCount);
+        int v = 1 + (int)(nextRandom(&state) % userCount);
+        if (u != v) insertFriendship(graph, u, v);
+    }
+
+    int ids[NAME_SEARCH_LIMIT];
+    int queries = 1000000;
+    long long found = 0;
+    start = clock();
+    for (int i = 0; i < queries; i++) {
+        sprintf(name, "û%d", 1 + (int)(nextRandom(&state) % userCount));
+        found += findUsersByName(graph, name, ids, NAME_SEARCH_LIMIT);
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("Ʋ %d Σϣ%.3f 룬ÿ %.3f ΢룬ҵ %lld \n",
+           queries, seconds, seconds * 1e6 / queries, found);
+
+    int scans = 100;
+    found = 0;
+    start = clock();
+    for (int i = 0; i < scans; i++) {
+        sprintf(name, "û%d", 1 + (int)(nextRandom(&state) % userCount));
+        for (int u = 1; u < graph->nextId; u++) {
+            if (graph->users[u].exists && strcmp(graph->users[u].name, name) == 0) found++;
+        }
+    }
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("Ʋ %d ΣȽϣ%.3f 룬ÿ %.3f ΢룬ҵ %lld \n",
+           scans, seconds, seconds * 1e6 / scans, found);
+
+    start = clock();
+    found = findUsersByPrefix(graph, "û12", ids, NAME_SEARCH_LIMIT);
+    printf("ǰ׺ңһΣ򣩣%.3f 룬ҵ %lld \n",
+           (double)(clock() - start) / CLOCKS_PER_SEC, found);
+    found = 0;
+    start = clock();
+    for (int i = 0; i < queries; i++) {
+        sprintf(name, "û%d", 1 + (int)(nextRandom(&state) % 1000));
+        found += findUsersByPrefix(graph, name, ids, NAME_SEARCH_LIMIT);
+    }
+    printf("ǰ׺ %d Σ%.3f 룬ҵ %lld \n",
+           queries, (double)(clock() - start) / CLOCKS_PER_SEC, found);
+
+    // ɾʮ֮һûͬѹϵͬûIDȫ
+    int deleteCount = userCount / 10;
+    int edgesBefore = graph->edgeSet.count;
+    int deleted = 0;
+    start = clock();
+    for (int i = 0; i < deleteCount; i++) {
+        if (deleteUser(graph, 1 + (int)(nextRandom(&state) % userCount)) == 1) deleted++;
+    }
+    printf("ɾ %d û%.3f 룬ɾѹϵ %d \n", deleted,
+           (double)(clock() - start) / CLOCKS_PER_SEC, edgesBefore - graph->edgeSet.count);
+
+    int nextIdBefore = graph->nextId;
+    start = clock();
+    for (int i = 0; i < deleted; i++) {
+        sprintf(name, "û%d", i + 1);
+        insertUser(graph, name);
+    }
+    printf(" %d û%.3f 룬·ID %d \n", deleted,
+           (double)(clock() - start) / CLOCKS_PER_SEC, graph->nextId - nextIdBefore);
+    printf("============================================\n\n");
+    freeGraph(graph);
+}
+// Erdos-Renyiͼ G(n, m)userCountûedgeCountѡĺѣظڽͼʱȥ
+int generateErdosRenyiEdges(int userCount, long long edgeCount, EdgeList* list) {
+    unsigned long long state = 88172645463325252ULL;
+    for (long long e = 0; e < edgeCount; e++) {
+        int from = 1 + (int)(nextRandom(&state) % userCount);
+        int to = 1 + (int)(nextRandom(&state) % userCount);
+        if (!acceptEdge(list, from, to)) return 0;
+    }
+    return 1;
+}
+// Barabasi-AlbertƫͼedgesPerUser + 1˵ȫͼʼ֮ÿûedgesPerUser
+// ѡûĸȣȼɵĺѹϵȡһ
+int generateBarabasiAlbertEdges(int userCount, int edgesPerUser, EdgeList* list) {
+    unsigned long long state = 88172645463325252ULL;
+    if (edgesPerUser < 1) edgesPerUser = 1;
+    int seedCount = (edgesPerUser + 1 < userCount) ? edgesPerUser + 1 : userCount;
+    for (int u = 1; u <= seedCount; u++) {
+        for (int v = u + 1; v <= seedCount; v++) {
+            if (!appendEdge(list, u, v)) return 0;
+        }
+    }
+
+    for (int u = seedCount + 1; u <= userCount; u++) {
+        long long existing = list->count;  // ֻû֮ǰĺѹϵѡ
+        for (int k = 0; k < edgesPerUser; k++) {
+            long long end = (long long)(nextRandom(&state) % (unsigned long long)(2 * existing));
+            int target = (end & 1) ? list->to[end / 2] : list->from[end / 2];
+            if (!appendEdge(list, u, target)) return 0;
+        }
+    }
+    return 1;
+}
+// R-MATͼĺѹϵ2^scaleûedgeFactor * 2^scaleԺ
+// ÿԺڽӾֳĿ飬0.570.190.190.05ѡһ飬õɷֲĺ
+int generateRmatEdges(int scale, int edgeFactor, EdgeList* list) {
+    unsigned long long state = 88172645463325252ULL;
+    long long edgeCount = (long long)edgeFactor << scale;
+    for (long long e = 0; e < edgeCount; e++) {
+        int from = 0, to = 0;
+        for (int level = 0; level < scale; level++) {
+            double r = (double)(nextRandom(&state) >> 11) / 9007199254740992.0;  // [0,1)
+            int row = 0, column = 0;
+            if (r >= 0.57 && r < 0.76) {
+                column = 1;
+            } else if (r >= 0.76 && r < 0.95) {
+                row = 1;
+            } else if (r >= 0.95) {
+                row = 1;
+                column = 1;
+            }
+            from = from * 2 + row;
+            to = to * 2 + column;
+        }
+        if (!acceptEdge(list, from + 1, to + 1)) return 0;  // ûID1ʼ
+    }
+    return 1;
+}
+#if ENABLE_CONCURRENT_GRAPH
+// ܲһ̵߳Ĳͽ
+typedef struct {
+    ConcurrentGraph* cg;
+    atomic_bool* running;
+    int userCount;
+    unsigned long long seed;
+    long long operations;        // ɵĲ
+    long long checksum;          // ѯۼӣֹѯŻ
+} ConcurrentWorker;
+
+// ̣߳ÿȡһοһѯжϺѺͺż̾룩
+int concurrentReaderMain(void* arg) {
+    ConcurrentWorker* worker = (ConcurrentWorker*)arg;
+    unsigned long long state = worker->seed;
+    while (atomic_load(worker->running)) {
+        const ConcurrentSnapshot* snapshot = acquireSnapshot(worker->cg);
+        if (snapshot == NULL) break;
+        for (int i = 0; i < 64; i++) {
+            int u = 1 + (int)(nextRandom(&state) % worker->userCount);
+            int v = 1 + (int)(nextRandom(&state) % worker->userCount);
+            worker->checksum += snapshotAreFriends(snapshot, u, v) + snapshotFriendCount(snapshot, u);
+        }
+        // ̾Ҫͼÿ65536βѯһ
+        if ((worker->operations & 65535) == 0) {
+            int u = 1 + (int)(nextRandom(&state) % worker->userCount);
+            int v = 1 + (int)(nextRandom(&state) % worker->userCount);
+            worker->checksum += snapshotDistance(snapshot, u, v);
+        }
+        releaseSnapshot(worker->cg);
+        worker->operations += 64;
+    }
+    unregisterReader(worker->cg);
+    freeSearchScratch();
+    return 0;
+}
+// д̣߳ϼѣɾ4096֮ǰӵĺѣʹѹϵȶ
+int concurrentWriterMain(void* arg) {
+    ConcurrentWorker* worker = (ConcurrentWorker*)arg;
+    unsigned long long addState = worker->seed;
+    unsigned long long removeState = worker->seed;
+    while (atomic_load(worker->running)) {
+        int u = 1 + (int)(nextRandom(&addState) % worker->userCount);
+        int v = 1 + (int)(nextRandom(&addState) % worker->userCount);
+        concurrentAddFriend(worker->cg, u, v);
+        worker->operations++;
+        if (worker->operations > 4096) {
+            u = 1 + (int)(nextRandom(&removeState) % worker->userCount);
+            v = 1 + (int)(nextRandom(&removeState) % worker->userCount);
+            concurrentRemoveFriend(worker->cg, u, v);
+            worker->operations++;
+        }
+    }
+    return 0;
+}
+// ģʽܲԣreaderCount̺߳1д߳ͬʱseconds룬дʵӳ
+void runConcurrentBenchmark(int readerCount, int seconds, int maxStalenessMs) {
+    if (readerCount <= 0 || readerCount >= MAX_READER_THREADS) readerCount = 4;
+    if (seconds <= 0) seconds = 5;
+    if (maxStalenessMs <= 0) maxStalenessMs = DEFAULT_MAX_STALENESS_MS;
+    int userCount = 200000;
+    int avgDegree = 20;
+
+    Graph* graph = createGraph(userCount + 1);
+    if (graph == NULL) return;
+    printf("\n========== ģʽܲ ==========\n");
+    char name[32];
+    for (int i = 0; i < userCount; i++) {
+        sprintf(name, "û%d", i + 1);
+        insertUser(graph, name);
+    }
+    unsigned long long state = 88172645463325252ULL;
+    for (long long i = 0; i < (long long)userCount * avgDegree / 2; i++) {
+        int u = 1 + (int)(nextRandom(&state) % userCount);
+        int v = 1 + (int)(nextRandom(&state) % userCount);
+        if (u != v) insertFriendship(graph, u, v);
+    }
+    printf("%d û%d ѹϵ%d ̣߳1 д̣߳Ŀӳ %d \n",
+           userCount, graph->edgeSet.count, readerCount, maxStalenessMs);
+
+    ConcurrentGraph* cg = startConcurrentGraph(graph, maxStalenessMs, 0);
+    if (cg == NULL) {
+        freeGraph(graph);
+        return;
+    }
+
+    atomic_bool running;
+    atomic_init(&running, true);
+    ConcurrentWorker workers[MAX_READER_THREADS];
+    thrd_t threads[MAX_READER_THREADS];
+    int started = 0;
+    for (int i = 0; i <= readerCount; i++) {
+        workers[i].cg = cg;
+        workers[i].running = &running;
+        workers[i].userCount = userCount;
+        workers[i].seed = 0x9E3779B97F4A7C15ULL * (i + 1);
+        workers[i].operations = 0;
+        workers[i].checksum = 0;
+        // һд߳
+        thrd_start_t body = (i < readerCount) ? concurrentReaderMain : concurrentWriterMain;
+        if (thrd_create(&threads[i], body, &workers[i]) != thrd_success) break;
+        started++;
     }
 
-    // BFS
-    int queue[MAX_USERS];
-    int front = 0, rear = 0;
-    bool visited[MAX_USERS] = {false};
-    int parent[MAX_USERS];
-    int distance[MAX_USERS];
+    long long start = currentNanos();
+    struct timespec duration = {seconds, 0};
+    thrd_sleep(&duration, NULL);
+    atomic_store(&running, false);
+    for (int i = 0; i < started; i++) {
+        thrd_join(threads[i], NULL);
+    }
+    double elapsed = (currentNanos() - start) / 1e9;
 
-    // ʼ
-    for (int i = 0; i < MAX_USERS; i++) {
-        parent[i] = -1;
-        distance[i] = -1;
+    long long reads = 0, checksum = 0;
+    for (int i = 0; i < started && i < readerCount; i++) {
+        reads += workers[i].operations;
+        checksum += workers[i].checksum;
     }
+    long long writes = (started > readerCount) ? workers[readerCount].operations : 0;
 
-    // ʼڵ㿪ʼBFS
-    queue[rear++] = fromUserId;
-    visited[fromUserId] = true;
-    distance[fromUserId] = 0;
+    flushConcurrentGraph(cg);
+    long long publishCount = cg->publishCount;
+    long long visibleWrites = cg->visibleWrites;
+    long long lateWrites = cg->lateWrites;
+    double averageStaleness = (visibleWrites > 0) ? cg->totalStalenessNanos / 1e6 / visibleWrites : 0;
+    double maxStaleness = cg->maxStalenessNanos / 1e6;
+    graph = stopConcurrentGraph(cg);
 
-    while (front < rear) {
-        int current = queue[front++];
+    printf("%lld Σÿ %.0f ΣУ %lld\n", reads, reads / elapsed, checksum);
+    printf("д%lld Σÿ %.0f \n", writes, writes / elapsed);
+    printf(" %lld дӵɼƽ %.2f 룬 %.2f \n",
+           publishCount, averageStaleness, maxStaleness);
+    printf("Ŀӳ %d д%lld ռ %.3f%%\n", maxStalenessMs, lateWrites,
+           visibleWrites > 0 ? 100.0 * lateWrites / visibleWrites : 0.0);
+    printf("ʱ %d ѹϵ\n", graph->edgeSet.count);
+    printf("======================================\n\n");
+    freeGraph(graph);
+}
+#endif
+// ͼܲԣR-MATͼϷֱPageRankμϵÿ봦ĺѹϵ
+void runAnalyticsBenchmark(int scale, int edgeFactor) {
+    if (scale <= 0 || scale > 26) scale = 20;
+    if (edgeFactor <= 0) edgeFactor = 16;
 
-        // ҵĿڵ
-        if (current == toUserId) {
-            // ·
-            *pathLength = 0;
-            int node = toUserId;
-            while (node != -1) {
-                path[(*pathLength)++] = node;
-                node = parent[node];
-            }
+    printf("\n========== ͼܲ ==========\n");
+    EdgeList list = {NULL, NULL, 0, 0, 0};
+    clock_t start = clock();
+    Graph* graph = NULL;
+    if (generateRmatEdges(scale, edgeFactor, &list)) {
+        graph = buildGraphFromEdges(&list);
+    } else {
+        printf("ڴʧܣ\n");
+    }
+    free(list.from);
+    free(list.to);
+    if (graph == NULL) return;
 
-            // ת·ΪǴĿݵ㣩
-            for (int i = 0; i < *pathLength / 2; i++) {
-                int temp = path[i];
-                path[i] = path[*pathLength - 1 - i];
-                path[*pathLength - 1 - i] = temp;
-            }
+    double edges = graph->edgeSet.count;
+    printf("R-MATͼscale %dedgeFactor %d%d û%d ѹϵ %d %.3f \n",
+           scale, edgeFactor, graph->userCount, graph->edgeSet.count, graph->maxDegree,
+           (double)(clock() - start) / CLOCKS_PER_SEC);
 
-            return distance[toUserId];
-        }
+    double* values = (double*)malloc(graph->nextId * sizeof(double));
+    if (values != NULL) {
+        start = clock();
+        int iterations = computePageRank(graph, values);
+        double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+        printf("PageRank %d ֣%.3f 룬ÿ %.0f ѹϵÿÿΣ\n",
+               iterations, seconds, edges * 2 * iterations / (seconds > 0 ? seconds : 1e-9));
 
-        // ڽӽڵ
-        AdjListNode* adjNode = graph->adjLists[current].head;
-        while (adjNode != NULL) {
-            int neighbor = adjNode->userId;
-            if (!visited[neighbor]) {
-                visited[neighbor] = true;
-                queue[rear++] = neighbor;
-                parent[neighbor] = current;
-                distance[neighbor] = distance[current] + 1;
-            }
-            adjNode = adjNode->next;
-        }
-    }
+        start = clock();
+        long long triangles = countTriangles(graph);
+        seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+        printf("μ%lld %.3f 룬ÿ %.0f ѹϵ\n",
+               triangles, seconds, edges / (seconds > 0 ? seconds : 1e-9));
 
-    return -1;  // ɴ
+        start = clock();
+        double average = computeClusteringCoefficients(graph, values);
+        seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+        printf("ϵƽ %.4f%.3f 룬ÿ %.0f ѹϵ\n",
+               average, seconds, edges / (seconds > 0 ? seconds : 1e-9));
+        free(values);
+    }
+    printf("====================================\n\n");
+    freeGraph(graph);
 }
-// ҹͬ
-void findCommonFriends(Graph* graph, int userId1, int userId2,
-                       int* commonFriends, int* count) {
-    *count = 0;
+// ȨѹϵܲԣR-MATͼȨء¼Ƚάܺ
+// ÿɨеĴۣԼDijkstraѣBFSٶ
+void runWeightedBenchmark(int scale, int edgeFactor) {
+    if (scale <= 0 || scale > 26) scale = 20;
+    if (edgeFactor <= 0) edgeFactor = 16;
 
-    // ȡûĺб
-    int friends1[MAX_USERS], count1;
-    int friends2[MAX_USERS], count2;
+    printf("\n========== Ȩѹϵܲ ==========\n");
+    EdgeList list = {NULL, NULL, 0, 0, 0};
+    int generated = generateRmatEdges(scale, edgeFactor, &list);
+    Graph* graph = generated ? buildGraphFromEdges(&list) : NULL;
+    if (!generated) printf("ڴʧܣ\n");
+    free(list.from);
+    free(list.to);
+    if (graph == NULL) return;
 
-    getFriends(graph, userId1, friends1, &count1);
-    getFriends(graph, userId2, friends2, &count2);
+    int userCount = graph->nextId - 1;
+    int queries = 20, interactions = 1000000;
+    int* path = (int*)malloc(graph->nextId * sizeof(int));
+    int* pairs = (int*)malloc(2 * interactions * sizeof(int));
+    if (path == NULL || pairs == NULL || userCount < 2 || !enableEdgeAttributes(graph)) {
+        printf("ڴʧܣ\n");
+        free(path);
+        free(pairs);
+        freeGraph(graph);
+        return;
+    }
+    printf("R-MATͼ%d û%d ѹϵռ %.1f MB\n", graph->userCount,
+           graph->edgeSet.count,
+           ((double)graph->rowStart[graph->userCapacity] * sizeof(EdgeAttr) +
+            (double)graph->userCapacity * (STRONG_TIE_COUNT * sizeof(StrongTie) + sizeof(int))) / 1048576.0);
 
-    // ҽͬѣ
-    for (int i = 0; i < count1; i++) {
-        for (int j = 0; j < count2; j++) {
-            if (friends1[i] == friends2[j]) {
-                commonFriends[(*count)++] = friends1[i];
-                break;
-            }
+    // ÿѹϵһ1100Ȩ
+    unsigned long long state = 20240601ULL;
+    clock_t start = clock();
+    for (int u = 1; u < graph->nextId; u++) {
+        const int* row = graph->neighbors + graph->rowStart[u];
+        for (int i = 0; i < graph->baseDegree[u]; i++) {
+            if (row[i] > u) setFriendshipWeight(graph, u, row[i], 1 + (int)(nextRandom(&state) % 100));
         }
     }
-}
-// ƼѣѵĺѣųѾǺѵģ
-void recommendFriends(Graph* graph, int userId,
-                      int* recommendations, int* count) {
-    *count = 0;
-    bool isFriend[MAX_USERS] = {false};
-    bool visited[MAX_USERS] = {false};
+    printf(" %d ѹϵȨأ%.3f \n", graph->edgeSet.count,
+           (double)(clock() - start) / CLOCKS_PER_SEC);
 
-    // ֱӺ
-    int friends[MAX_USERS], friendCount;
-    getFriends(graph, userId, friends, &friendCount);
-    for (int i = 0; i < friendCount; i++) {
-        isFriend[friends[i]] = true;
+    // ѡһкѵûѡһѣVĺѲĻࣩ
+    for (int i = 0; i < interactions; i++) {
+        int u;
+        do {
+            u = 1 + (int)(nextRandom(&state) % userCount);
+        } while (graph->baseDegree[u] == 0);
+        pairs[2 * i] = u;
+        pairs[2 * i + 1] = graph->neighbors[graph->rowStart[u] + nextRandom(&state) % graph->baseDegree[u]];
+    }
+    start = clock();
+    for (int i = 0; i < interactions; i++) {
+        recordInteraction(graph, pairs[2 * i], pairs[2 * i + 1], 1);
     }
-    isFriend[userId] = true;  // ųԼ
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("¼ %d Σάܺѣ%.3f 룬ÿ %.0f \n",
+           interactions, seconds, seconds * 1e9 / interactions);
 
-    // ѵĺ
-    for (int i = 0; i < friendCount; i++) {
-        int friendId = friends[i];
-        AdjListNode* adjNode = graph->adjLists[friendId].head;
-        while (adjNode != NULL) {
-            int friendOfFriend = adjNode->userId;
-            // ųѾǺѵĺԼ
-            if (!isFriend[friendOfFriend] && !visited[friendOfFriend]) {
-                recommendations[(*count)++] = friendOfFriend;
-                visited[friendOfFriend] = true;  // ظ
-            }
-            adjNode = adjNode->next;
-        }
+    // Աȣάÿλɨ˫ĺѡܺ
+    start = clock();
+    for (int i = 0; i < interactions; i++) {
+        int u = pairs[2 * i], v = pairs[2 * i + 1];
+        findEdgeAttr(graph, u, v)->interactions++;
+        findEdgeAttr(graph, v, u)->interactions++;
+        rebuildStrongTies(graph, u);
+        rebuildStrongTies(graph, v);
     }
-}
-// Ȧͨ- ʹDFS
-void findConnectedComponent(Graph* graph, int userId,
-                           bool* visited, int* component, int* count) {
-    visited[userId] = true;
-    component[(*count)++] = userId;
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("¼ %d Σÿɨ˫У%.3f 룬ÿ %.0f \n",
+           interactions, seconds, seconds * 1e9 / interactions);
 
-    // ݹڽӽڵ
-    AdjListNode* current = graph->adjLists[userId].head;
-    while (current != NULL) {
-        if (!visited[current->userId]) {
-            findConnectedComponent(graph, current->userId, visited, component, count);
+    // ͬһյֱBFS·ͼȨ·
+    for (int i = 0; i < queries; i++) {
+        pairs[2 * i] = 1 + (int)(nextRandom(&state) % userCount);
+        pairs[2 * i + 1] = 1 + (int)(nextRandom(&state) % userCount);
+    }
+    int pathLength;
+    long long checksum = 0;
+    start = clock();
+    for (int i = 0; i < queries; i++) {
+        checksum += findShortestPath(graph, pairs[2 * i], pairs[2 * i + 1], path, &pathLength);
+    }
+    printf("BFS· %d Σ%.3f 룬֮ %lld\n",
+           queries, (double)(clock() - start) / CLOCKS_PER_SEC, checksum);
+    checksum = 0;
+    long long hops = 0;
+    start = clock();
+    for (int i = 0; i < queries; i++) {
+        long long cost = findWeightedPath(graph, pairs[2 * i], pairs[2 * i + 1], path, &pathLength);
+        if (cost >= 0) {
+            checksum += cost;
+            hops += pathLength - 1;
         }
-        current = current->next;
     }
+    printf("Ȩ· %d ΣDijkstra + ѣ%.3f 룬Ȩ֮ %lld֮ %lld\n",
+           queries, (double)(clock() - start) / CLOCKS_PER_SEC, checksum, hops);
+    printf("==========================================\n\n");
+
+    free(path);
+    free(pairs);
+    freeGraph(graph);
 }
-// ʾû
-void displayAllUsers(Graph* graph) {
-    if (graph->userCount == 0) {
-        printf("û\n");
-        return;
-    }
+// һļʱһJSONp50/p99/ӳ٣룩ÿ
+void reportLatencies(const char* graphType, const char* operation, long long* nanos, int count) {
+    if (count <= 0) return;
 
-    printf("\n========== ûб ==========\n");
-    printf("%-6s %-30s %-10s\n", "ID", "û", "");
-    printf("------------------------------------------------------------\n");
+    long long total = 0;
+    for (int i = 0; i < count; i++) total += nanos[i];
+    qsort(nanos, count, sizeof(long long), compareLongLongs);
+    printf("{\"graph\":\"%s\",\"operation\":\"%s\",\"count\":%d,\"p50_ns\":%lld,\"p99_ns\":%lld,"
+           "\"max_ns\":%lld,\"ops_per_sec\":%.1f}\n",
+           graphType, operation, count, nanos[(count - 1) / 2],
+           nanos[(long long)(count - 1) * 99 / 100], nanos[count - 1],
+           count / (total > 0 ? total / 1e9 : 1e-9));
+}
+// ̵ķֵڴ棨KB/proc/self/statusеVmHWMֵ֧ϵͳ-1
+long long peakResidentKb() {
+    FILE* file = fopen("/proc/self/status", "r");
+    if (file == NULL) return -1;
 
-    for (int i = 1; i < MAX_USERS; i++) {
-        if (graph->users[i].exists) {
-            int friends[MAX_USERS], count;
-            getFriends(graph, i, friends, &count);
-            printf("%-6d %-30s %-10d\n", i, graph->users[i].name, count);
+    char line[256];
+    long long kb = -1;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (strncmp(line, "VmHWM:", 6) == 0) {
+            kb = atoll(line + 6);
+            break;
         }
     }
-    printf("================================\n\n");
+    fclose(file);
+    return kb;
 }
-// ʾûĺб
-void displayFriends(Graph* graph, int userId) {
-    if (!graph->users[userId].exists) {
-        printf("ûڣ\n");
+// ۺܲԣERBAR-MATͼ2^scaleûƽavgDegreeμʱ
+// ÿһJSONһǷֵڴ棬ڲͬ汾ֱ֮ӱȽ
+void runBenchmarkSuite(const char* graphType, int scale, int avgDegree, int queries) {
+    if (scale <= 0 || scale > 26) scale = 16;
+    if (avgDegree <= 0) avgDegree = 16;
+    if (queries <= 0) queries = 10000;
+    int userCount = 1 << scale;
+    int heavyQueries = (queries >= HEAVY_QUERY_RATIO) ? queries / HEAVY_QUERY_RATIO : 1;
+    int halfDegree = (avgDegree >= 2) ? avgDegree / 2 : 1;
+
+    EdgeList list = {NULL, NULL, 0, 0, 0};
+    long long start = currentNanos();
+    int generated;
+    if (strcmp(graphType, "er") == 0) {
+        generated = generateErdosRenyiEdges(userCount, (long long)userCount * halfDegree, &list);
+    } else if (strcmp(graphType, "ba") == 0) {
+        generated = generateBarabasiAlbertEdges(userCount, halfDegree, &list);
+    } else {
+        graphType = "rmat";
+        generated = generateRmatEdges(scale, halfDegree, &list);
+    }
+    Graph* graph = generated ? buildGraphFromEdges(&list) : NULL;
+    if (!generated) printf("ڴʧܣ\n");
+    free(list.from);
+    free(list.to);
+    if (graph == NULL) return;
+    printf("{\"graph\":\"%s\",\"users\":%d,\"friendships\":%d,\"max_degree\":%d,\"build_ms\":%.1f}\n",
+           graphType, graph->userCount, graph->edgeSet.count, graph->maxDegree,
+           (currentNanos() - start) / 1e6);
+    if (graph->nextId - 1 < 2) {
+        printf("û̫٣޷ԣ\n");
+        freeGraph(graph);
         return;
     }
 
-    int friends[MAX_USERS], count;
-    getFriends(graph, userId, friends, &count);
+    long long* nanos = (long long*)malloc(queries * sizeof(long long));
+    int* pairs = (int*)malloc(2 * queries * sizeof(int));
+    int* results = (int*)malloc(graph->userCapacity * sizeof(int));
+    int* circleIds = (int*)malloc(graph->userCapacity * sizeof(int));
+    int* circleSizes = (int*)malloc(graph->userCapacity * sizeof(int));
+    Recommendation top[DEFAULT_RECOMMEND_COUNT];
+    if (nanos == NULL || pairs == NULL || results == NULL || circleIds == NULL || circleSizes == NULL) {
+        printf("ڴʧܣ\n");
+        free(nanos);
+        free(pairs);
+        free(results);
+        free(circleIds);
+        free(circleSizes);
+        freeGraph(graph);
+        return;
+    }
 
-    printf("\nû %d (%s) ĺб\n", userId, graph->users[userId].name);
-    if (count == 0) {
-        printf("  ޺\n");
-    } else {
-        for (int i = 0; i < count; i++) {
-            printf("  - û %d: %s\n", friends[i], graph->users[friends[i]].name);
+    // ӺûǺѵûԣɾٰɾͼָԭ
+    userCount = graph->nextId - 1;  // R-MATͼбļûûкѣᱻ
+    unsigned long long state = 0x9E3779B97F4A7C15ULL;
+    for (int i = 0; i < queries; i++) {
+        int u = 1, v = 2;
+        for (int attempt = 0; attempt < 64; attempt++) {  // СĳͼҲ64
+            u = 1 + (int)(nextRandom(&state) % userCount);
+            v = 1 + (int)(nextRandom(&state) % userCount);
+            if (u != v && !areFriends(graph, u, v)) break;
         }
+        if (u == v) v = u % userCount + 1;
+        pairs[2 * i] = u;
+        pairs[2 * i + 1] = v;
     }
-    printf("\n");
-}
-// ʾ·
-void displayPath(Graph* graph, int* path, int pathLength, int degree) {
-    if (degree < 0) {
-        printf("û֮䲻ɴ\n");
-        return;
+    int count, length;
+    for (int i = 0; i < queries; i++) {
+        start = currentNanos();
+        insertFriendship(graph, pairs[2 * i], pairs[2 * i + 1]);
+        nanos[i] = currentNanos() - start;
     }
+    reportLatencies(graphType, "addFriend", nanos, queries);
+    for (int i = 0; i < queries; i++) {
+        start = currentNanos();
+        deleteFriendship(graph, pairs[2 * i], pairs[2 * i + 1]);
+        nanos[i] = currentNanos() - start;
+    }
+    reportLatencies(graphType, "removeFriend", nanos, queries);
 
-    printf("\n·%dȺѣ\n", degree);
-    for (int i = 0; i < pathLength; i++) {
-        printf("  û %d: %s", path[i], graph->users[path[i]].name);
-        if (i < pathLength - 1) {
-            printf("  ");
-        }
+    for (int i = 0; i < heavyQueries; i++) {
+        start = currentNanos();
+        findShortestPath(graph, pairs[2 * i], pairs[2 * i + 1], results, &length);
+        nanos[i] = currentNanos() - start;
     }
-    printf("\n\n");
-}
-// ˵
-void showMainMenu() {
-    printf("\n========== 罻ϵͳ ==========\n");
-    printf("1. û\n");
-    printf("2. Ӻѹϵ\n");
-    printf("3. ɾѹϵ\n");
-    printf("4. ʾû\n");
-    printf("5. 鿴б\n");
-    printf("6. ·Ⱥѣ\n");
-    printf("7. ҹͬ\n");
-    printf("8. Ƽ\n");
-    printf("9. Ȧ\n");
-    printf("10. ͳϢ\n");
-    printf("0. ˳\n");
-    printf("==================================\n");
-    printf("ѡ");
-}
-// ûϢ
-void inputUserInfo(char* name) {
-    printf("ûƣ");
-    fgets(name, MAX_NAME_LEN, stdin);
-    name[strcspn(name, "\n")] = 0;  // Ƴз
-}
-// ͳϢ
-void displayStatistics(Graph* graph) {
-    int totalFriends = 0;
-    int maxFriends = 0;
-    int minFriends = MAX_USERS;
-    int userWithMaxFriends = -1;
+    reportLatencies(graphType, "findShortestPath", nanos, heavyQueries);
+    for (int i = 0; i < queries; i++) {
+        start = currentNanos();
+        findShortestPathBidirectional(graph, pairs[2 * i], pairs[2 * i + 1], results, &length, 0);
+        nanos[i] = currentNanos() - start;
+    }
+    reportLatencies(graphType, "findShortestPathBidirectional", nanos, queries);
 
-    // ûͳϢ
-    for (int i = 1; i < MAX_USERS; i++) {
-        if (graph->users[i].exists) {
-            int friends[MAX_USERS], count;
-            getFriends(graph, i, friends, &count);
-            totalFriends += count;
-            if (count > maxFriends) {
-                maxFriends = count;
-                userWithMaxFriends = i;
-            }
-            if (count < minFriends) {
-                minFriends = count;
-            }
-        }
+    for (int i = 0; i < queries; i++) {
+        start = currentNanos();
+        findCommonFriends(graph, pairs[2 * i], pairs[2 * i + 1], results, &count);
+        nanos[i] = currentNanos() - start;
     }
+    reportLatencies(graphType, "findCommonFriends", nanos, queries);
 
-    printf("\n========== ͳϢ ==========\n");
-    printf("û%d\n", graph->userCount);
-    printf("ѹϵ%d\n", totalFriends / 2);  // ͼÿ
-    if (graph->userCount > 0) {
-        printf("ƽ%.2f\n", (float)totalFriends / graph->userCount);
-        printf("%dû %d: %s\n",
-               maxFriends, userWithMaxFriends, graph->users[userWithMaxFriends].name);
-        printf("ٺ%d\n", minFriends);
+    for (int i = 0; i < queries; i++) {
+        start = currentNanos();
+        recommendFriends(graph, pairs[2 * i], results, &count);
+        nanos[i] = currentNanos() - start;
     }
-    printf("==============================\n\n");
+    reportLatencies(graphType, "recommendFriends", nanos, queries);
+    for (int i = 0; i < queries; i++) {
+        start = currentNanos();
+        recommendTopFriends(graph, pairs[2 * i], top, DEFAULT_RECOMMEND_COUNT);
+        nanos[i] = currentNanos() - start;
+    }
+    reportLatencies(graphType, "recommendTopFriends", nanos, queries);
+
+    for (int i = 0; i < heavyQueries; i++) {
+        start = currentNanos();
+        findConnectedComponent(graph, pairs[2 * i], results, &count);
+        nanos[i] = currentNanos() - start;
+    }
+    reportLatencies(graphType, "findConnectedComponent", nanos, heavyQueries);
+    for (int i = 0; i < heavyQueries; i++) {
+        start = currentNanos();
+        labelFriendCircles(graph, circleIds, circleSizes, false);
+        nanos[i] = currentNanos() - start;
+    }
+    reportLatencies(graphType, "labelFriendCircles", nanos, heavyQueries);
+
+    printf("{\"graph\":\"%s\",\"peak_rss_kb\":%lld}\n", graphType, peakResidentKb());
+    free(nanos);
+    free(pairs);
+    free(results);
+    free(circleIds);
+    free(circleSizes);
+    freeSearchScratch();
+    freeGraph(graph);
 }
-int main() {
-    // 1. ʼͼ
-    Graph* graph = initGraph();
+int main(int argc, char* argv[]) {
+    // в --bench [û] [ƽ] [ѯ] [uniform|powerlaw]ܲ
+    if (argc >= 2 && strcmp(argv[1], "--bench") == 0) {
+        runGraphBenchmark((argc >= 3) ? atoi(argv[2]) : 1000,
+                          (argc >= 4) ? atoi(argv[3]) : 20,
+                          (argc >= 5) ? atoi(argv[4]) : 10000,
+                          !(argc >= 6 && strcmp(argv[5], "uniform") == 0));
+        return 0;
+    }
+    // в --bench-suite [er|ba|rmat] [scale] [ƽ] [ѯ]ۺܲԣÿһJSON
+    if (argc >= 2 && strcmp(argv[1], "--bench-suite") == 0) {
+        runBenchmarkSuite((argc >= 3) ? argv[2] : "rmat",
+                          (argc >= 4) ? atoi(argv[3]) : 0,
+                          (argc >= 5) ? atoi(argv[4]) : 0,
+                          (argc >= 6) ? atoi(argv[5]) : 0);
+        return 0;
+    }
+    // в --bench-edges [ѹϵ]Ժѹϵɾ飨Ĭ1
+    if (argc >= 2 && strcmp(argv[1], "--bench-edges") == 0) {
+        runEdgeBenchmark((argc >= 3) ? atoll(argv[2]) : 0);
+        return 0;
+    }
+    // в --bench-analytics [scale] [edgeFactor]R-MATͼϲͼĬ2^20û
+    if (argc >= 2 && strcmp(argv[1], "--bench-analytics") == 0) {
+        runAnalyticsBenchmark((argc >= 3) ? atoi(argv[2]) : 20, (argc >= 4) ? atoi(argv[3]) : 16);
+        return 0;
+    }
+    // в --bench-weighted [scale] [edgeFactor]ԼȨ·ܺĬ2^20û
+    if (argc >= 2 && strcmp(argv[1], "--bench-weighted") == 0) {
+        runWeightedBenchmark((argc >= 3) ? atoi(argv[2]) : 20, (argc >= 4) ? atoi(argv[3]) : 16);
+        return 0;
+    }
+    // в --bench-users [û]԰ƲҺɾûĬ100û
+    if (argc >= 2 && strcmp(argv[1], "--bench-users") == 0) {
+        runUserBenchmark((argc >= 3) ? atoi(argv[2]) : 0);
+        return 0;
+    }
+    // в --bench-concurrent [߳] [] [Ŀӳٺ]ԲģʽĶдӳ
+    if (argc >= 2 && strcmp(argv[1], "--bench-concurrent") == 0) {
+#if ENABLE_CONCURRENT_GRAPH
+        runConcurrentBenchmark((argc >= 3) ? atoi(argv[2]) : 0,
+                               (argc >= 4) ? atoi(argv[3]) : 0,
+                               (argc >= 5) ? atoi(argv[4]) : 0);
+#else
+        printf("ǰ뻷ֲ֧ģʽ\n");
+#endif
+        return 0;
+    }
+    // в --bench-load [ѹϵ]ԵѹϵбͼգĬ1ǧ
+    if (argc >= 2 && strcmp(argv[1], "--bench-load") == 0) {
+        runLoadBenchmark((argc >= 3) ? atoll(argv[2]) : 0);
+        return 0;
+    }
+
+    // 1. ʼͼ --load-snapshot ļ  --load-edges ļ [binary] ļ
+    Graph* graph;
+    bool loadedFromFile = true;
+    if (argc >= 3 && strcmp(argv[1], "--load-snapshot") == 0) {
+        graph = loadGraphSnapshot(argv[2]);
+    } else if (argc >= 3 && strcmp(argv[1], "--load-edges") == 0) {
+        graph = loadEdgeList(argv[2], argc >= 4 && strcmp(argv[3], "binary") == 0);
+    } else {
+        graph = initGraph();
+        loadedFromFile = false;
+    }
+    if (graph == NULL) return 1;
 
     // 2. 
     int choice;
     int userId1, userId2, userId;
     char name[MAX_NAME_LEN];
-    int path[MAX_USERS], pathLength;
-    int commonFriends[MAX_USERS], commonCount;
-    int recommendations[MAX_USERS], recCount;
+    char fileName[MAX_FILE_NAME_LEN];
+    int pathLength, commonCount, recCount;
+    int* results = NULL;   // ѯ飬û
+    int resultCapacity = 0;
 
     printf("ӭʹ罻ѹϵϵͳ\n");
 
-    // 3. Ӳݣѡ
-    addUser(graph, "");
-    addUser(graph, "");
-    addUser(graph, "");
-    addUser(graph, "");
-    addFriend(graph, 1, 2);
-    addFriend(graph, 1, 3);
-    addFriend(graph, 2, 4);
-    addFriend(graph, 3, 4);
+    // 3. Ӳݣѡļʱӣ
+    if (!loadedFromFile) {
+        addUser(graph, "");
+        addUser(graph, "");
+        addUser(graph, "");
+        addUser(graph, "");
+        addFriend(graph, 1, 2);
+        addFriend(graph, 1, 3);
+        addFriend(graph, 2, 4);
+        addFriend(graph, 3, 4);
+        recordInteraction(graph, 1, 2, 3);
+        recordInteraction(graph, 1, 3, 1);
+    }
 
     // 4. ѭ
     while (1) {
@@ -476,6 +5258,17 @@ int main() {
         scanf("%d", &choice);
         getchar(); // 뻺
 
+        // ѯûûӺ
+        if (resultCapacity < graph->nextId) {
+            int* newResults = (int*)realloc(results, graph->userCapacity * sizeof(int));
+            if (newResults == NULL) {
+                printf("ڴʧܣ\n");
+                continue;
+            }
+            results = newResults;
+            resultCapacity = graph->userCapacity;
+        }
+
         switch (choice) {
             case 1: // û
                 inputUserInfo(name);
@@ -521,8 +5314,9 @@ int main() {
                 scanf("%d", &userId2);
                 getchar();
                 {
-                    int degree = findShortestPath(graph, userId1, userId2, path, &pathLength);
-                    displayPath(graph, path, pathLength, degree);
+                    int degree = findShortestPathBidirectional(graph, userId1, userId2,
+                                                               results, &pathLength, 0);
+                    displayPath(graph, results, pathLength, degree);
                 }
                 break;
 
@@ -534,15 +5328,15 @@ int main() {
                 scanf("%d", &userId2);
                 getchar();
                 {
-                    findCommonFriends(graph, userId1, userId2, commonFriends, &commonCount);
+                    findCommonFriends(graph, userId1, userId2, results, &commonCount);
                     if (commonCount == 0) {
                         printf("\nû %d û %d ûйͬѡ\n\n", userId1, userId2);
                     } else {
                         printf("\nû %d û %d Ĺͬѣ\n", userId1, userId2);
                         for (int i = 0; i < commonCount; i++) {
                             printf("  - û %d: %s\n",
-                                   commonFriends[i],
-                                   graph->users[commonFriends[i]].name);
+                                   results[i],
+                                   graph->users[results[i]].name);
                         }
                         printf("\n");
                     }
@@ -554,15 +5348,19 @@ int main() {
                 scanf("%d", &userId);
                 getchar();
                 {
-                    recommendFriends(graph, userId, recommendations, &recCount);
+                    Recommendation recommendations[DEFAULT_RECOMMEND_COUNT];
+                    recCount = recommendTopFriends(graph, userId, recommendations,
+                                                   DEFAULT_RECOMMEND_COUNT);
                     if (recCount == 0) {
                         printf("\nƼѡ\n\n");
                     } else {
-                        printf("\nƼѣѵĺѣ\n");
+                        printf("\nƼѣѵĺѣͬѼȨ򣩣\n");
                         for (int i = 0; i < recCount; i++) {
-                            printf("  - û %d: %s\n",
-                                   recommendations[i],
-                                   graph->users[recommendations[i]].name);
+                            printf("  - û %d: %sͬ %d ÷ %.2f\n",
+                                   recommendations[i].userId,
+                                   graph->users[recommendations[i].userId].name,
+                                   recommendations[i].mutualCount,
+                                   recommendations[i].score);
                         }
                         printf("\n");
                     }
@@ -574,9 +5372,9 @@ int main() {
                 scanf("%d", &userId);
                 getchar();
                 {
-                    bool visited[MAX_USERS] = {false};
-                    int component[MAX_USERS], count = 0;
-                    findConnectedComponent(graph, userId, visited, component, &count);
+                    int* component = results;
+                    int count;
+                    findConnectedComponent(graph, userId, component, &count);
 
                     printf("\nû %d Ȧͨ\n", userId);
                     for (int i = 0; i < count; i++) {
@@ -590,18 +5388,165 @@ int main() {
                 displayStatistics(graph);
                 break;
 
+            case 11: // Ȧͳ
+                displayCircleStatistics(graph);
+                break;
+
+            case 12: // ͼ
+                inputFileName(fileName);
+                if (saveGraphSnapshot(graph, fileName)) {
+                    printf("ͼѱ浽 %s\n", fileName);
+                }
+                break;
+
+            case 13: // ͼգ滻ǰͼ
+            case 14: // ѹϵб滻ǰͼ
+                inputFileName(fileName);
+                {
+                    Graph* loaded;
+                    if (choice == 13) {
+                        loaded = loadGraphSnapshot(fileName);
+                    } else {
+                        int format;
+                        printf("ѡļʽ1. ı  2. ƣ");
+                        scanf("%d", &format);
+                        getchar();
+                        loaded = loadEdgeList(fileName, format == 2);
+                    }
+                    if (loaded != NULL) {
+                        freeGraph(graph);
+                        graph = loaded;
+                        printf("ɹ %d û%d ѹϵ\n",
+                               graph->userCount, graph->edgeSet.count);
+                    }
+                }
+                break;
+
+            case 15: // Ӱָ
+                displayInfluenceStatistics(graph);
+                break;
+
+            case 16: // Ʋû
+                inputUserInfo(name);
+                displayUsersByName(graph, name);
+                break;
+
+            case 17: // ɾû
+                printf("ûID");
+                scanf("%d", &userId);
+                getchar();
+                removeUser(graph, userId);
+                break;
+
+            case 18: // Nڵĺ
+                printf("ûID");
+                scanf("%d", &userId);
+                getchar();
+                {
+                    int hops;
+                    printf("N");
+                    scanf("%d", &hops);
+                    getchar();
+                    displayNeighborhood(graph, userId, hops);
+                }
+                break;
+
+            case 19: // ¼ѻ
+                printf("û1 ID");
+                scanf("%d", &userId1);
+                getchar();
+                printf("û2 ID");
+                scanf("%d", &userId2);
+                getchar();
+                {
+                    int times;
+                    printf("뻥");
+                    scanf("%d", &times);
+                    getchar();
+                    int result = (times > 0) ? recordInteraction(graph, userId1, userId2, times) : 0;
+                    if (times <= 0) {
+                        printf("\n");
+                    } else if (result == 0) {
+                        printf("û %d û %d Ǻѣ\n", userId1, userId2);
+                    } else if (result < 0) {
+                        printf("ڴʧܣ\n");
+                    } else {
+                        printf("Ѽ¼û %d û %d  %d Ρ\n", userId1, userId2,
+                               findEdgeAttr(graph, userId1, userId2)->interactions);
+                    }
+                }
+                break;
+
+            case 20: // úѹϵȨ
+                printf("û1 ID");
+                scanf("%d", &userId1);
+                getchar();
+                printf("û2 ID");
+                scanf("%d", &userId2);
+                getchar();
+                {
+                    int weight;
+                    printf("ȨأȨ·еľ룩");
+                    scanf("%d", &weight);
+                    getchar();
+                    int result = (weight > 0) ? setFriendshipWeight(graph, userId1, userId2, weight) : 0;
+                    if (weight <= 0) {
+                        printf("Ȩر\n");
+                    } else if (result == 0) {
+                        printf("û %d û %d Ǻѣ\n", userId1, userId2);
+                    } else if (result < 0) {
+                        printf("ڴʧܣ\n");
+                    } else {
+                        printf("Ȩóɹ\n");
+                    }
+                }
+                break;
+
+            case 21: // 鿴ܵĺ
+                printf("ûID");
+                scanf("%d", &userId);
+                getchar();
+                displayStrongestTies(graph, userId);
+                break;
+
+            case 22: // ҼȨ·
+                printf("ʼûID");
+                scanf("%d", &userId1);
+                getchar();
+                printf("ĿûID");
+                scanf("%d", &userId2);
+                getchar();
+                {
+                    long long cost = findWeightedPath(graph, userId1, userId2, results, &pathLength);
+                    displayWeightedPath(graph, results, pathLength, cost);
+                }
+                break;
+
+            case 23: // ڲĺ
+                {
+                    int days, minInteractions;
+                    printf("Ϊѳô죩");
+                    scanf("%d", &days);
+                    getchar();
+                    printf("ٻĺѹϵɾ");
+                    scanf("%d", &minInteractions);
+                    getchar();
+                    long long before = (long long)time(NULL) - (long long)days * SECONDS_PER_DAY;
+                    int removed = expireStaleFriendships(graph, before, minInteractions);
+                    if (removed < 0) {
+                        printf("ڴʧܣ\n");
+                    } else {
+                        printf("ɾ %d ڲĺѹϵ\n", removed);
+                    }
+                }
+                break;
+
             case 0: // ˳
                 printf("лʹãټ\n");
                 // ͷͼڴ
-                for (int i = 0; i < MAX_USERS; i++) {
-                    AdjListNode* current = graph->adjLists[i].head;
-                    while (current != NULL) {
-                        AdjListNode* temp = current;
-                        current = current->next;
-                        free(temp);
-                    }
-                }
-                free(graph);
+                freeGraph(graph);
+                freeSearchScratch();
+                free(results);
                 return 0;
 
             default: